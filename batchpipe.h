@@ -0,0 +1,339 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "vector.h"
+
+// Передача пакетов от потока-производителя потоку-потребителю через
+// фиксированный набор переиспользуемых буферов (двойная или N-буферизация).
+// После конструирования память не выделяется: буферы ходят по кругу между
+// очередями свободных и заполненных
+template <typename T>
+class BatchPipe {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Пакет передаётся потребителю, когда в нём batch_size элементов или когда
+    // с момента первого элемента прошло flush_timeout
+    BatchPipe(size_t buffer_count, size_t batch_size, Clock::duration flush_timeout = Clock::duration::max())
+            : buffers_(buffer_count)
+            , free_(buffer_count)
+            , full_(buffer_count)
+            , batch_size_(batch_size)
+            , flush_timeout_(flush_timeout) {
+        assert(buffer_count > 0 && batch_size > 0);
+        for (size_t i = 0; i < buffer_count; ++i) {
+            buffers_[i].Reserve(batch_size);
+            free_.Push(i);
+        }
+    }
+
+    BatchPipe(const BatchPipe&) = delete;
+    BatchPipe& operator=(const BatchPipe&) = delete;
+
+    // Методы производителя. Элемент дописывается в собственный буфер
+    // производителя без блокировки; mutex_ берётся только на границах пакета
+
+    // Блокируется, пока не освободится буфер
+    template <typename Val>
+    void Push(Val&& value) {
+        CheckOpen();
+        if (!BeginWrite()) {
+            std::unique_lock lock(mutex_);
+            free_cv_.wait(lock, [this] {
+                return !free_.Empty();
+            });
+            StartBatchLocked();
+        }
+        Append(std::forward<Val>(value));
+    }
+
+    // Возвращает false, не трогая value, если свободных буферов нет
+    template <typename Val>
+    bool TryPush(Val&& value) {
+        CheckOpen();
+        if (!BeginWrite()) {
+            std::lock_guard lock(mutex_);
+            if (free_.Empty()) {
+                return false;
+            }
+            StartBatchLocked();
+        }
+        Append(std::forward<Val>(value));
+        return true;
+    }
+
+    // Передаёт потребителю неполный пакет, если он есть
+    void Flush() {
+        if (BeginWrite()) {
+            HandOffOrRelease(buffers_[current_].Size() > 0);
+        }
+    }
+
+    // Передаёт неполный пакет, если истёк таймаут, не дожидаясь потребителя
+    void FlushIfExpired() {
+        if (BeginWrite()) {
+            HandOffOrRelease(buffers_[current_].Size() > 0 && Clock::now() >= batch_deadline_);
+        }
+    }
+
+    // Передаёт остаток и сообщает потребителю, что новых пакетов не будет.
+    // Push и TryPush после Close выбрасывают std::logic_error
+    void Close() {
+        if (producer_closed_) {
+            return;
+        }
+        const bool owned = BeginWrite();
+        producer_closed_ = true;
+        {
+            std::lock_guard lock(mutex_);
+            if (owned) {
+                if (buffers_[current_].Size() > 0) {
+                    HandOffLocked();
+                } else {
+                    free_.Push(current_);
+                    current_ = NONE;
+                }
+            }
+            closed_ = true;
+        }
+        full_cv_.notify_all();
+    }
+
+    // Методы потребителя
+
+    // Ждёт пакет и вызывает для него func(Vector<T>&). Неполный пакет забирается,
+    // как только истечёт flush_timeout, даже если производитель простаивает.
+    // Возвращает false, когда канал закрыт и все пакеты обработаны.
+    // func не должна забирать буфер себе
+    template <typename Func>
+    bool Consume(Func&& func) {
+        size_t index;
+        {
+            std::unique_lock lock(mutex_);
+            while (!TakeLocked(index)) {
+                if (closed_ && partial_ == NONE) {
+                    return false;
+                }
+                if (partial_ == NONE) {
+                    full_cv_.wait(lock);
+                } else if (Clock::now() < partial_deadline_) {
+                    full_cv_.wait_until(lock, partial_deadline_);
+                } else {
+                    // Производитель как раз дописывает элемент; буфер освободится через мгновение
+                    lock.unlock();
+                    std::this_thread::yield();
+                    lock.lock();
+                }
+            }
+        }
+        Process(index, std::forward<Func>(func));
+        return true;
+    }
+
+    // Обрабатывает пакет, если он уже готов, иначе сразу возвращает false
+    template <typename Func>
+    bool TryConsume(Func&& func) {
+        size_t index;
+        {
+            std::lock_guard lock(mutex_);
+            if (!TakeLocked(index)) {
+                return false;
+            }
+        }
+        Process(index, std::forward<Func>(func));
+        return true;
+    }
+
+    [[nodiscard]] size_t BatchSize() const noexcept {
+        return batch_size_;
+    }
+
+private:
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+
+    // Очередь индексов буферов фиксированной ёмкости
+    class IndexQueue {
+    public:
+        explicit IndexQueue(size_t capacity)
+                : slots_(capacity) {
+        }
+
+        void Push(size_t index) noexcept {
+            assert(count_ < slots_.Size());
+            slots_[(head_ + count_) % slots_.Size()] = index;
+            ++count_;
+        }
+
+        size_t Pop() noexcept {
+            assert(count_ > 0);
+            size_t index = slots_[head_];
+            head_ = (head_ + 1) % slots_.Size();
+            --count_;
+            return index;
+        }
+
+        [[nodiscard]] bool Empty() const noexcept {
+            return count_ == 0;
+        }
+
+    private:
+        Vector<size_t> slots_;
+        size_t head_ = 0;
+        size_t count_ = 0;
+    };
+
+    // Состояние неполного пакета для передачи по таймауту: потребитель забирает
+    // буфер, только переведя его из IDLE в CLAIMED, а производитель пишет,
+    // только переведя его из IDLE в WRITING
+    enum BufferState : uint8_t {
+        IDLE,
+        WRITING,
+        CLAIMED,
+    };
+
+    void CheckOpen() const {
+        if (producer_closed_) {
+            throw std::logic_error("BatchPipe: push after Close");
+        }
+    }
+
+    // Захватывает текущий буфер для записи. false — буфера нет или его уже
+    // забрал потребитель по таймауту
+    bool BeginWrite() {
+        if (current_ == NONE) {
+            return false;
+        }
+        if (HasTimeout()) {
+            uint8_t expected = IDLE;
+            if (!state_.compare_exchange_strong(expected, WRITING, std::memory_order_acquire)) {
+                assert(expected == CLAIMED);
+                current_ = NONE;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void StartBatchLocked() {
+        current_ = free_.Pop();
+        state_.store(WRITING, std::memory_order_relaxed);
+    }
+
+    template <typename Val>
+    void Append(Val&& value) {
+        Vector<T>& batch = buffers_[current_];
+        try {
+            batch.PushBack(std::forward<Val>(value));
+        } catch (...) {
+            state_.store(IDLE, std::memory_order_release);
+            throw;
+        }
+
+        if (batch.Size() == batch_size_) {
+            HandOffOrRelease(true);
+        } else if (HasTimeout()) {
+            if (batch.Size() == 1) {
+                // Начало пакета: потребитель узнаёт срок, после которого может забрать буфер
+                batch_deadline_ = Deadline(Clock::now());
+                std::lock_guard lock(mutex_);
+                partial_ = current_;
+                partial_deadline_ = batch_deadline_;
+                full_cv_.notify_one();
+            }
+            state_.store(IDLE, std::memory_order_release);
+        }
+    }
+
+    void HandOffOrRelease(bool hand_off) {
+        if (hand_off) {
+            std::lock_guard lock(mutex_);
+            HandOffLocked();
+        } else if (HasTimeout()) {
+            state_.store(IDLE, std::memory_order_release);
+        }
+    }
+
+    // Очередь заполненных вмещает все буферы, поэтому передача не блокируется
+    void HandOffLocked() {
+        full_.Push(current_);
+        partial_ = NONE;
+        current_ = NONE;
+        full_cv_.notify_one();
+    }
+
+    [[nodiscard]] bool HasTimeout() const noexcept {
+        return flush_timeout_ != Clock::duration::max();
+    }
+
+    [[nodiscard]] Clock::time_point Deadline(Clock::time_point start) const noexcept {
+        return flush_timeout_ < Clock::time_point::max() - start ? start + flush_timeout_ : Clock::time_point::max();
+    }
+
+    // Берёт готовый пакет или неполный пакет с истёкшим таймаутом, если
+    // производитель не пишет в него в этот момент
+    bool TakeLocked(size_t& index) {
+        if (!full_.Empty()) {
+            index = full_.Pop();
+            return true;
+        }
+        if (partial_ != NONE && Clock::now() >= partial_deadline_) {
+            uint8_t expected = IDLE;
+            if (state_.compare_exchange_strong(expected, CLAIMED, std::memory_order_acquire)) {
+                index = partial_;
+                partial_ = NONE;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename Func>
+    void Process(size_t index, Func&& func) {
+        // Буфер возвращается в свободные, даже если func выбросила исключение
+        struct Release {
+            BatchPipe& pipe;
+            size_t index;
+
+            ~Release() {
+                pipe.buffers_[index].Clear();
+                {
+                    std::lock_guard lock(pipe.mutex_);
+                    pipe.free_.Push(index);
+                }
+                pipe.free_cv_.notify_one();
+            }
+        } release{*this, index};
+        func(buffers_[index]);
+    }
+
+    Vector<Vector<T>> buffers_;
+
+    std::mutex mutex_;
+    std::condition_variable free_cv_;
+    std::condition_variable full_cv_;
+    IndexQueue free_;
+    IndexQueue full_;
+    bool closed_ = false;
+    // Неполный пакет, который потребитель может забрать после partial_deadline_
+    size_t partial_ = NONE;
+    Clock::time_point partial_deadline_;
+
+    std::atomic<uint8_t> state_ = IDLE;
+
+    const size_t batch_size_;
+    const Clock::duration flush_timeout_;
+
+    // Состояние производителя, доступно только его потоку
+    size_t current_ = NONE;
+    Clock::time_point batch_deadline_;
+    bool producer_closed_ = false;
+};
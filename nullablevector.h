@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "vector.h"
+
+// Вектор значений, допускающих отсутствие. Значения хранятся плотно в Vector<T>,
+// а признак наличия — в отдельной битовой карте (бит i в слове i / 64, формат
+// масок SelectMask), поэтому на элемент тратится один бит вместо выравнивания
+// std::optional, а циклы по значениям остаются векторизуемыми.
+// На месте отсутствующих значений лежит произвольное содержимое
+template <typename T>
+class NullableVector {
+    static_assert(std::is_arithmetic_v<T>, "NullableVector requires arithmetic elements");
+
+public:
+    using SumType = std::conditional_t<std::is_floating_point_v<T>, double,
+                                       std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return values_.Size();
+    }
+
+    [[nodiscard]] size_t NullCount() const noexcept {
+        return null_count_;
+    }
+
+    [[nodiscard]] bool AllValid() const noexcept {
+        return null_count_ == 0;
+    }
+
+    [[nodiscard]] bool IsValid(size_t index) const noexcept {
+        assert(index < Size());
+        return (validity_[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+    }
+
+    [[nodiscard]] std::optional<T> operator[](size_t index) const noexcept {
+        return IsValid(index) ? std::optional<T>(values_[index]) : std::nullopt;
+    }
+
+    const Vector<T>& Values() const noexcept {
+        return values_;
+    }
+
+    const Vector<uint64_t>& Validity() const noexcept {
+        return validity_;
+    }
+
+    void Reserve(size_t new_capacity) {
+        values_.Reserve(new_capacity);
+        validity_.Reserve(WordCount(new_capacity));
+    }
+
+    void PushBack(T value) {
+        const size_t index = Size();
+        values_.PushBack(value);
+        GrowValidity(index + 1);
+        validity_[index / WORD_BITS] |= uint64_t{1} << (index % WORD_BITS);
+    }
+
+    void PushNull() {
+        values_.PushBack(T{});
+        GrowValidity(Size());
+        ++null_count_;
+    }
+
+    void PushBack(std::optional<T> value) {
+        if (value) {
+            PushBack(*value);
+        } else {
+            PushNull();
+        }
+    }
+
+    // Дописывает все values как присутствующие
+    void Append(const Vector<T>& values) {
+        const size_t old_size = Size();
+        AppendValues(values);
+        SetRange(old_size, Size());
+    }
+
+    // Дописывает values с признаками наличия из mask (бит i — значение values[i]).
+    // Слова маски сдвигаются и сливаются с картой целиком, без обхода по битам
+    void Append(const Vector<T>& values, const Vector<uint64_t>& mask) {
+        const size_t count = values.Size();
+        if (mask.Size() < WordCount(count)) {
+            throw std::invalid_argument("Validity mask is shorter than the values");
+        }
+        const size_t old_size = Size();
+        AppendValues(values);
+        GrowValidity(old_size + count);
+
+        const size_t shift = old_size % WORD_BITS;
+        uint64_t* out = validity_.begin() + old_size / WORD_BITS;
+        size_t valid = 0;
+        for (size_t word = 0; word < WordCount(count); ++word) {
+            uint64_t bits = mask[word];
+            const size_t rest = count - word * WORD_BITS;
+            if (rest < WORD_BITS) {
+                bits &= (uint64_t{1} << rest) - 1;
+            }
+            valid += std::popcount(bits);
+            out[word] |= bits << shift;
+            if (shift != 0 && (bits >> (WORD_BITS - shift)) != 0) {
+                out[word + 1] |= bits >> (WORD_BITS - shift);
+            }
+        }
+        null_count_ += count - valid;
+    }
+
+    // Сумма присутствующих значений. Складывается по 64 независимым
+    // частичным суммам, поэтому результат для чисел с плавающей точкой может
+    // отличаться от последовательного сложения в последних разрядах
+    [[nodiscard]] SumType Sum() const noexcept {
+        return Fold(SumType{}, [](SumType a, SumType b) {
+            return a + b;
+        });
+    }
+
+    // Минимум присутствующих значений или nullopt, если их нет
+    [[nodiscard]] std::optional<T> Min() const noexcept {
+        return Extremum([](T a, T b) {
+            return b < a ? b : a;
+        }, Highest());
+    }
+
+    [[nodiscard]] std::optional<T> Max() const noexcept {
+        return Extremum([](T a, T b) {
+            return a < b ? b : a;
+        }, Lowest());
+    }
+
+private:
+    static constexpr size_t WORD_BITS = 64;
+
+    static constexpr size_t WordCount(size_t size) noexcept {
+        return (size + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    static constexpr T Highest() noexcept {
+        if constexpr (std::numeric_limits<T>::has_infinity) {
+            return std::numeric_limits<T>::infinity();
+        } else {
+            return std::numeric_limits<T>::max();
+        }
+    }
+
+    static constexpr T Lowest() noexcept {
+        if constexpr (std::numeric_limits<T>::has_infinity) {
+            return -std::numeric_limits<T>::infinity();
+        } else {
+            return std::numeric_limits<T>::lowest();
+        }
+    }
+
+    // Расширяет карту до size бит; новые биты нулевые (значения отсутствуют)
+    void GrowValidity(size_t size) {
+        const size_t words = WordCount(size);
+        if (words > validity_.Size()) {
+            if (words > validity_.Capacity()) {
+                validity_.Reserve(std::max(words, validity_.Capacity() * 2));
+            }
+            validity_.Resize(words);
+        }
+    }
+
+    void SetRange(size_t first, size_t last) {
+        GrowValidity(last);
+        while (first < last) {
+            const size_t bit = first % WORD_BITS;
+            const size_t count = std::min(WORD_BITS - bit, last - first);
+            const uint64_t mask = count == WORD_BITS ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+            validity_[first / WORD_BITS] |= mask << bit;
+            first += count;
+        }
+    }
+
+    void AppendValues(const Vector<T>& values) {
+        const size_t old_size = Size();
+        const size_t new_size = old_size + values.Size();
+        if (new_size > values_.Capacity()) {
+            values_.Reserve(std::max(new_size, values_.Capacity() * 2));
+        }
+        values_.ResizeForOverwrite(new_size);
+        if (values.Size() > 0) {
+            std::memcpy(values_.begin() + old_size, values.begin(), values.Size() * sizeof(T));
+        }
+    }
+
+    // Беззнаковое целое того же размера, что и Acc
+    template <typename Acc>
+    using RawBits = std::conditional_t<sizeof(Acc) == 1, uint8_t,
+                                       std::conditional_t<sizeof(Acc) == 2, uint16_t,
+                                                          std::conditional_t<sizeof(Acc) == 4, uint32_t, uint64_t>>>;
+
+    // Байт карты -> восемь масок 0x00/0xFF: биты раскрываются таблицей, а не
+    // сдвигом на переменную величину, которого нет в SSE2 для 64-битных полос
+    struct ByteMasks {
+        int8_t masks[256][8];
+
+        constexpr ByteMasks()
+                : masks{} {
+            for (size_t byte = 0; byte < 256; ++byte) {
+                for (size_t bit = 0; bit < 8; ++bit) {
+                    masks[byte][bit] = ((byte >> bit) & 1) ? -1 : 0;
+                }
+            }
+        }
+    };
+
+    static constexpr ByteMasks BYTE_MASKS{};
+
+    // Свёртка присутствующих значений по словам карты. Частичный результат
+    // ведётся для каждой позиции слова, поэтому цепочка зависимостей не тянется
+    // через весь вектор и цикл векторизуется как поэлементный даже для чисел с
+    // плавающей точкой. Полные слова без пропусков сворачиваются напрямую,
+    // пустые пропускаются, а в остальных значение читается всегда и вместо
+    // отсутствующего битовой маской выбирается identity: в цикле нет переходов.
+    // Выбор идёт над битовым представлением, поэтому годится и для double.
+    // Циклы записаны здесь, а не в отдельных функциях: partial локален, и
+    // компилятору не нужна проверка на пересечение с data
+    template <typename Acc, typename Op>
+    Acc Fold(Acc identity, Op op) const noexcept {
+        using AccRaw = RawBits<Acc>;
+
+        Acc partial[WORD_BITS];
+        std::fill(std::begin(partial), std::end(partial), identity);
+        const AccRaw raw_identity = std::bit_cast<AccRaw>(identity);
+
+        const T* data = values_.begin();
+        const size_t size = Size();
+        const size_t full = size - size % WORD_BITS;
+        for (size_t base = 0; base < full; base += WORD_BITS) {
+            const uint64_t bits = null_count_ == 0 ? ~uint64_t{0} : validity_[base / WORD_BITS];
+            const T* word = data + base;
+            if (bits == ~uint64_t{0}) {
+                for (size_t i = 0; i < WORD_BITS; ++i) {
+                    partial[i] = op(partial[i], static_cast<Acc>(word[i]));
+                }
+            } else if (bits != 0) {
+                int8_t keep[WORD_BITS];
+                for (size_t byte = 0; byte < WORD_BITS / 8; ++byte) {
+                    std::memcpy(keep + byte * 8, BYTE_MASKS.masks[(bits >> (byte * 8)) & 0xFF], 8);
+                }
+                for (size_t i = 0; i < WORD_BITS; ++i) {
+                    const AccRaw raw = std::bit_cast<AccRaw>(static_cast<Acc>(word[i]));
+                    const auto mask = static_cast<AccRaw>(static_cast<std::make_signed_t<AccRaw>>(keep[i]));
+                    const auto selected = static_cast<AccRaw>(raw_identity ^ ((raw ^ raw_identity) & mask));
+                    partial[i] = op(partial[i], std::bit_cast<Acc>(selected));
+                }
+            }
+        }
+        if (full < size) {
+            const uint64_t bits = validity_[full / WORD_BITS];
+            for (size_t i = full; i < size; ++i) {
+                if ((bits >> (i - full)) & 1) {
+                    partial[i - full] = op(partial[i - full], static_cast<Acc>(data[i]));
+                }
+            }
+        }
+
+        Acc result = partial[0];
+        for (size_t i = 1; i < WORD_BITS; ++i) {
+            result = op(result, partial[i]);
+        }
+        return result;
+    }
+
+    template <typename Op>
+    std::optional<T> Extremum(Op op, T identity) const noexcept {
+        if (null_count_ == Size()) {
+            return std::nullopt;
+        }
+        return Fold(identity, op);
+    }
+
+    Vector<T> values_;
+    Vector<uint64_t> validity_;
+    size_t null_count_ = 0;
+};
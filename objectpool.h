@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "rawmemory.h"
+#include "vector.h"
+
+// Пул объектов одного типа. Объекты размещаются в крупных блоках RawMemory и
+// никогда не перемещаются; освобождённые ячейки связываются в интрузивный
+// список и переиспользуются. Для частых операций из многих потоков служит
+// Cache — локальный список потока, обменивающийся с общим пакетами
+template <typename T>
+class ObjectPool {
+    union Slot {
+        Slot* next;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+public:
+    explicit ObjectPool(size_t chunk_size = 1024)
+            : chunk_size_(chunk_size) {
+        assert(chunk_size > 0);
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Память блоков освобождается, но деструкторы живых объектов не вызываются:
+    // перед разрушением пула GetAliveObjectCount() должен быть равен нулю
+    ~ObjectPool() = default;
+
+    template <typename... Args>
+    T* Create(Args&&... args) {
+        Slot* slot;
+        {
+            std::lock_guard lock(mutex_);
+            slot = AcquireLocked();
+        }
+        try {
+            return Construct(slot, std::forward<Args>(args)...);
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            slot->next = free_;
+            free_ = slot;
+            throw;
+        }
+    }
+
+    void Destroy(T* obj) noexcept {
+        Slot* slot = Release(obj);
+        std::lock_guard lock(mutex_);
+        slot->next = free_;
+        free_ = slot;
+    }
+
+    // Локальный кеш свободных ячеек. Принадлежит одному потоку; объекты можно
+    // создавать через один кеш, а освобождать через другой или через пул
+    class Cache {
+    public:
+        explicit Cache(ObjectPool& pool, size_t batch_size = 64)
+                : pool_(pool)
+                , batch_size_(batch_size) {
+            assert(batch_size > 0);
+        }
+
+        Cache(const Cache&) = delete;
+        Cache& operator=(const Cache&) = delete;
+
+        ~Cache() {
+            if (count_ > 0) {
+                pool_.ReturnBatch(head_, count_);
+            }
+        }
+
+        template <typename... Args>
+        T* Create(Args&&... args) {
+            if (head_ == nullptr) {
+                head_ = pool_.TakeBatch(batch_size_);
+                count_ = batch_size_;
+            }
+            Slot* slot = head_;
+            head_ = slot->next;
+            --count_;
+            try {
+                return pool_.Construct(slot, std::forward<Args>(args)...);
+            } catch (...) {
+                slot->next = head_;
+                head_ = slot;
+                ++count_;
+                throw;
+            }
+        }
+
+        void Destroy(T* obj) noexcept {
+            Slot* slot = pool_.Release(obj);
+            slot->next = head_;
+            head_ = slot;
+            // Излишек возвращается в общий список, чтобы память не застревала в потоке
+            if (++count_ >= 2 * batch_size_) {
+                Slot* rest = head_;
+                for (size_t i = 1; i < batch_size_; ++i) {
+                    rest = rest->next;
+                }
+                Slot* returned = head_;
+                head_ = rest->next;
+                rest->next = nullptr;
+                count_ -= batch_size_;
+                pool_.ReturnBatch(returned, batch_size_);
+            }
+        }
+
+    private:
+        ObjectPool& pool_;
+        const size_t batch_size_;
+        Slot* head_ = nullptr;
+        size_t count_ = 0;
+    };
+
+    [[nodiscard]] size_t GetAliveObjectCount() const noexcept {
+        return num_created_.load(std::memory_order_relaxed) - num_destroyed_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t NumCreated() const noexcept {
+        return num_created_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t NumDestroyed() const noexcept {
+        return num_destroyed_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t ChunkCount() {
+        std::lock_guard lock(mutex_);
+        return chunks_.Size();
+    }
+
+private:
+    // Если конструктор выбрасывает исключение, ячейку возвращает в свой список
+    // вызывающий: общий пул или кеш
+    template <typename... Args>
+    T* Construct(Slot* slot, Args&&... args) {
+        T* obj = ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+        num_created_.fetch_add(1, std::memory_order_relaxed);
+        return obj;
+    }
+
+    Slot* Release(T* obj) noexcept {
+        assert(obj != nullptr);
+        std::destroy_at(obj);
+        num_destroyed_.fetch_add(1, std::memory_order_relaxed);
+        return reinterpret_cast<Slot*>(obj);
+    }
+
+    // Берёт ячейку из списка свободных или отрезает новую от текущего блока
+    Slot* AcquireLocked() {
+        if (free_ != nullptr) {
+            Slot* slot = free_;
+            free_ = slot->next;
+            return slot;
+        }
+        if (chunks_.Size() == 0 || chunk_used_ == chunk_size_) {
+            chunks_.EmplaceBack(chunk_size_);
+            chunk_used_ = 0;
+        }
+        return chunks_[chunks_.Size() - 1].GetAddress() + chunk_used_++;
+    }
+
+    // Возвращает связный список ровно из count ячеек
+    Slot* TakeBatch(size_t count) {
+        std::lock_guard lock(mutex_);
+        Slot* head = nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            Slot* slot = AcquireLocked();
+            slot->next = head;
+            head = slot;
+        }
+        return head;
+    }
+
+    void ReturnBatch(Slot* head, size_t count) noexcept {
+        Slot* tail = head;
+        for (size_t i = 1; i < count; ++i) {
+            tail = tail->next;
+        }
+        std::lock_guard lock(mutex_);
+        tail->next = free_;
+        free_ = head;
+    }
+
+    const size_t chunk_size_;
+
+    std::mutex mutex_;
+    Vector<RawMemory<Slot>> chunks_;
+    // Количество уже выданных ячеек последнего блока
+    size_t chunk_used_ = 0;
+    Slot* free_ = nullptr;
+
+    std::atomic<size_t> num_created_ = 0;
+    std::atomic<size_t> num_destroyed_ = 0;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Замена Vector<std::unique_ptr<Base>>: объекты каждого конкретного типа лежат
+// подряд в собственном Vector<Derived> без отдельных выделений памяти, а обход
+// идёт тип за типом. Внутри ForEach статический тип элемента известен, поэтому
+// вызовы методов final-классов не требуют виртуальной диспетчеризации
+template <typename Base, typename... Derived>
+class PolyVector {
+    static_assert(sizeof...(Derived) > 0, "At least one derived type is required");
+    static_assert((std::is_base_of_v<Base, Derived> && ...), "All types must derive from Base");
+
+public:
+    template <typename D, typename... Args>
+    D& EmplaceBack(Args&&... args) {
+        return Get<D>().EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    template <typename D>
+    void PushBack(D&& value) {
+        EmplaceBack<std::remove_cvref_t<D>>(std::forward<D>(value));
+    }
+
+    template <typename D>
+    Vector<D>& Get() noexcept {
+        static_assert((std::is_same_v<D, Derived> || ...), "Type is not stored in this PolyVector");
+        return std::get<Vector<D>>(parts_);
+    }
+
+    template <typename D>
+    const Vector<D>& Get() const noexcept {
+        static_assert((std::is_same_v<D, Derived> || ...), "Type is not stored in this PolyVector");
+        return std::get<Vector<D>>(parts_);
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return (std::get<Vector<Derived>>(parts_).Size() + ...);
+    }
+
+    [[nodiscard]] bool Empty() const noexcept {
+        return Size() == 0;
+    }
+
+    void Clear() noexcept {
+        (std::get<Vector<Derived>>(parts_).Clear(), ...);
+    }
+
+    // Вызывает func для каждого элемента с его конкретным типом. Порядок — по
+    // типам в порядке Derived..., внутри типа — в порядке добавления
+    template <typename Func>
+    void ForEach(Func&& func) {
+        (ForEachOf<Derived>(func), ...);
+    }
+
+    template <typename Func>
+    void ForEach(Func&& func) const {
+        (ForEachOf<Derived>(func), ...);
+    }
+
+    // Обход через ссылку на базовый класс, если конкретный тип не важен
+    template <typename Func>
+    void ForEachBase(Func&& func) {
+        ForEach([&func](Base& value) {
+            func(value);
+        });
+    }
+
+    template <typename Func>
+    void ForEachBase(Func&& func) const {
+        ForEach([&func](const Base& value) {
+            func(value);
+        });
+    }
+
+private:
+    template <typename D, typename Func>
+    void ForEachOf(Func& func) {
+        for (D& value : std::get<Vector<D>>(parts_)) {
+            func(value);
+        }
+    }
+
+    template <typename D, typename Func>
+    void ForEachOf(Func& func) const {
+        for (const D& value : std::get<Vector<D>>(parts_)) {
+            func(value);
+        }
+    }
+
+    std::tuple<Vector<Derived>...> parts_;
+};
@@ -71,14 +71,28 @@ public:
     }
 
 private:
+    // Типы с выравниванием больше стандартного требуют выровненного operator new
+    static constexpr bool OVER_ALIGNED = alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
     // Выделяет сырую память под n элементов и возвращает указатель на неё
     static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+        if (n == 0) {
+            return nullptr;
+        }
+        if constexpr (OVER_ALIGNED) {
+            return static_cast<T*>(operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        } else {
+            return static_cast<T*>(operator new(n * sizeof(T)));
+        }
     }
 
     // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
     static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+        if constexpr (OVER_ALIGNED) {
+            operator delete(buf, std::align_val_t{alignof(T)});
+        } else {
+            operator delete(buf);
+        }
     }
 
     T* buffer_ = nullptr;
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Вектор, сжатый кодированием длин серий. Серия i — значение values_[i],
+// занимающее позиции [ends_[i - 1], ends_[i]). Доступ по индексу — двоичный
+// поиск по концам серий, обходы и свёртки выполняются за O(числа серий)
+template <typename T>
+class RleVector {
+public:
+    RleVector() = default;
+
+    static RleVector FromVector(const Vector<T>& vec) {
+        RleVector result;
+        size_t begin = 0;
+        while (begin < vec.Size()) {
+            size_t end = begin + 1;
+            while (end < vec.Size() && vec[end] == vec[begin]) {
+                ++end;
+            }
+            result.values_.PushBack(vec[begin]);
+            result.ends_.PushBack(end);
+            begin = end;
+        }
+        return result;
+    }
+
+    [[nodiscard]] Vector<T> ToVector() const {
+        Vector<T> result;
+        result.Reserve(Size());
+        for (size_t run = 0; run < values_.Size(); ++run) {
+            result.Resize(ends_[run], values_[run]);
+        }
+        return result;
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return ends_.Size() == 0 ? 0 : ends_[ends_.Size() - 1];
+    }
+
+    [[nodiscard]] size_t RunCount() const noexcept {
+        return values_.Size();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return values_[RunIndex(index)];
+    }
+
+    // Номер серии, содержащей элемент index
+    [[nodiscard]] size_t RunIndex(size_t index) const noexcept {
+        return std::upper_bound(ends_.begin(), ends_.end(), static_cast<uint64_t>(index)) - ends_.begin();
+    }
+
+    // Дописывает count копий value, продлевая последнюю серию при равенстве значений
+    void Append(const T& value, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        if (values_.Size() > 0 && values_[values_.Size() - 1] == value) {
+            ends_[ends_.Size() - 1] += count;
+        } else {
+            const uint64_t end = Size() + count;
+            values_.PushBack(value);
+            ends_.PushBack(end);
+        }
+    }
+
+    void PushBack(const T& value) {
+        Append(value, 1);
+    }
+
+    // func(value, begin, end) для каждой серии по порядку
+    template <typename Func>
+    void ForEachRun(Func&& func) const {
+        uint64_t begin = 0;
+        for (size_t run = 0; run < values_.Size(); ++run) {
+            func(values_[run], static_cast<size_t>(begin), static_cast<size_t>(ends_[run]));
+            begin = ends_[run];
+        }
+    }
+
+    // Сумма всех элементов: каждая серия учитывается одним умножением
+    template <typename Acc = std::conditional_t<std::is_floating_point_v<T>, double, int64_t>>
+    [[nodiscard]] Acc Sum() const {
+        Acc sum{};
+        ForEachRun([&sum](const T& value, size_t begin, size_t end) {
+            sum += static_cast<Acc>(value) * static_cast<Acc>(end - begin);
+        });
+        return sum;
+    }
+
+    [[nodiscard]] std::optional<T> Min() const {
+        if (values_.Size() == 0) {
+            return std::nullopt;
+        }
+        return *std::min_element(values_.begin(), values_.end());
+    }
+
+    [[nodiscard]] std::optional<T> Max() const {
+        if (values_.Size() == 0) {
+            return std::nullopt;
+        }
+        return *std::max_element(values_.begin(), values_.end());
+    }
+
+    // Количество элементов, равных value
+    [[nodiscard]] size_t Count(const T& value) const {
+        size_t count = 0;
+        ForEachRun([&](const T& run_value, size_t begin, size_t end) {
+            count += run_value == value ? end - begin : 0;
+        });
+        return count;
+    }
+
+    const Vector<T>& RunValues() const noexcept {
+        return values_;
+    }
+
+    const Vector<uint64_t>& RunEnds() const noexcept {
+        return ends_;
+    }
+
+private:
+    Vector<T> values_;
+    // Исключающие концы серий, строго возрастают
+    Vector<uint64_t> ends_;
+};
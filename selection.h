@@ -0,0 +1,229 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Выборки без копирования данных: фильтр строит вектор номеров подходящих
+// элементов (selection vector) или битовую маску, а последующие операции
+// работают через них, не материализуя отфильтрованную копию
+
+namespace detail {
+
+// Номера строк хранятся в uint32_t
+inline void CheckSelectable(size_t count) {
+    if (count > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Too many rows for a selection");
+    }
+}
+
+// Упаковывает 64 флага 0/1 в слово. Умножение собирает восемь байт-флагов
+// в старший байт произведения, так что сравнения остаются в отдельном
+// векторизуемом цикле, а упаковка не требует сдвигов на переменную величину
+inline uint64_t PackFlags(const uint8_t (&flags)[64]) noexcept {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < 64; i += 8) {
+        uint64_t chunk;
+        if constexpr (std::endian::native == std::endian::little) {
+            std::memcpy(&chunk, flags + i, sizeof(chunk));
+        } else {
+            chunk = 0;
+            for (size_t j = 0; j < 8; ++j) {
+                chunk |= static_cast<uint64_t>(flags[i + j]) << (8 * j);
+            }
+        }
+        bits |= ((chunk * 0x0102040810204080) >> 56) << i;
+    }
+    return bits;
+}
+
+// Вызывает emit(base, bits) для каждого слова битовой маски позиций
+// 0..count-1, в которых match(позиция) истинно. Предикат вычисляется
+// блоками по 64 позиции в массив флагов без ветвлений, что позволяет
+// компилятору векторизовать сравнение
+template <typename Match, typename Emit>
+void ForEachMaskWord(size_t count, Match& match, Emit&& emit) {
+    uint8_t flags[64];
+    size_t base = 0;
+    for (; base + 64 <= count; base += 64) {
+        for (size_t bit = 0; bit < 64; ++bit) {
+            flags[bit] = match(base + bit) ? 1 : 0;
+        }
+        emit(base, PackFlags(flags));
+    }
+    if (base < count) {
+        for (size_t bit = 0; bit < 64; ++bit) {
+            flags[bit] = base + bit < count && match(base + bit) ? 1 : 0;
+        }
+        emit(base, PackFlags(flags));
+    }
+}
+
+// Заполняет выборку номерами rows[i] (или i, если rows == nullptr), для которых
+// match истинно: сначала строится битовая маска, затем её биты разворачиваются
+// в номера
+template <typename Match>
+Vector<uint32_t> SelectRows(size_t count, const uint32_t* rows, Match&& match) {
+    Vector<uint32_t> selection;
+    selection.ResizeForOverwrite(count);
+    uint32_t* out = selection.begin();
+    // Ветви разделены, чтобы проверка rows не попала во внутренний цикл
+    if (rows == nullptr) {
+        CheckSelectable(count);
+        auto match_position = [&](size_t i) {
+            return match(static_cast<uint32_t>(i));
+        };
+        ForEachMaskWord(count, match_position, [&](size_t base, uint64_t bits) {
+            for (; bits != 0; bits &= bits - 1) {
+                *out++ = static_cast<uint32_t>(base + std::countr_zero(bits));
+            }
+        });
+    } else {
+        auto match_position = [&](size_t i) {
+            return match(rows[i]);
+        };
+        ForEachMaskWord(count, match_position, [&](size_t base, uint64_t bits) {
+            for (; bits != 0; bits &= bits - 1) {
+                *out++ = rows[base + std::countr_zero(bits)];
+            }
+        });
+    }
+    selection.Resize(out - selection.begin());
+    return selection;
+}
+
+}  // namespace detail
+
+// Номера элементов vec, удовлетворяющих pred. Выбрасывает std::length_error,
+// если номера не помещаются в uint32_t
+template <typename T, typename Pred>
+Vector<uint32_t> Select(const Vector<T>& vec, Pred&& pred) {
+    const T* data = vec.begin();
+    return detail::SelectRows(vec.Size(), nullptr, [&](uint32_t row) {
+        return pred(data[row]);
+    });
+}
+
+// Оставляет из selection только номера элементов, удовлетворяющих pred,
+// так что цепочка условий последовательно сужает выборку
+template <typename T, typename Pred>
+Vector<uint32_t> Select(const Vector<T>& vec, Pred&& pred, const Vector<uint32_t>& selection) {
+    const T* data = vec.begin();
+    return detail::SelectRows(selection.Size(), selection.begin(), [&](uint32_t row) {
+        return pred(data[row]);
+    });
+}
+
+// Битовая маска: бит i (в слове i / 64) установлен, если pred(vec[i])
+template <typename T, typename Pred>
+Vector<uint64_t> SelectMask(const Vector<T>& vec, Pred&& pred) {
+    const T* data = vec.begin();
+    Vector<uint64_t> mask;
+    mask.ResizeForOverwrite((vec.Size() + 63) / 64);
+    auto match = [&](size_t i) {
+        return pred(data[i]);
+    };
+    detail::ForEachMaskWord(vec.Size(), match, [&mask](size_t base, uint64_t bits) {
+        mask[base / 64] = bits;
+    });
+    return mask;
+}
+
+// Преобразует битовую маску в вектор номеров
+inline Vector<uint32_t> MaskToSelection(const Vector<uint64_t>& mask) {
+    detail::CheckSelectable(mask.Size() > 0 ? (mask.Size() - 1) * 64 : 0);
+    size_t count = 0;
+    for (uint64_t bits : mask) {
+        count += std::popcount(bits);
+    }
+    Vector<uint32_t> selection;
+    selection.ResizeForOverwrite(count);
+    size_t out = 0;
+    for (size_t word = 0; word < mask.Size(); ++word) {
+        for (uint64_t bits = mask[word]; bits != 0; bits &= bits - 1) {
+            selection[out++] = static_cast<uint32_t>(word * 64 + std::countr_zero(bits));
+        }
+    }
+    return selection;
+}
+
+template <typename T, typename Func>
+void ForEachSelected(Vector<T>& vec, const Vector<uint32_t>& selection, Func&& func) {
+    for (uint32_t row : selection) {
+        func(vec[row]);
+    }
+}
+
+template <typename T, typename Func>
+void ForEachSelected(const Vector<T>& vec, const Vector<uint32_t>& selection, Func&& func) {
+    for (uint32_t row : selection) {
+        func(vec[row]);
+    }
+}
+
+// Обход по битовой маске: пустые слова пропускаются целиком
+template <typename T, typename Func>
+void ForEachSelected(const Vector<T>& vec, const Vector<uint64_t>& mask, Func&& func) {
+    for (size_t word = 0; word < mask.Size(); ++word) {
+        for (uint64_t bits = mask[word]; bits != 0; bits &= bits - 1) {
+            func(vec[word * 64 + std::countr_zero(bits)]);
+        }
+    }
+}
+
+// Копирует выбранные элементы подряд в новый вектор
+template <typename T>
+Vector<T> GatherSelected(const Vector<T>& vec, const Vector<uint32_t>& selection) {
+    Vector<T> result;
+    if constexpr (std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>) {
+        result.ResizeForOverwrite(selection.Size());
+        for (size_t i = 0; i < selection.Size(); ++i) {
+            result[i] = vec[selection[i]];
+        }
+    } else {
+        result.Reserve(selection.Size());
+        for (uint32_t row : selection) {
+            result.EmplaceBack(vec[row]);
+        }
+    }
+    return result;
+}
+
+// Копирует элементы, отмеченные в битовой маске, подряд в новый вектор
+template <typename T>
+Vector<T> GatherSelected(const Vector<T>& vec, const Vector<uint64_t>& mask) {
+    size_t count = 0;
+    for (uint64_t bits : mask) {
+        count += std::popcount(bits);
+    }
+    Vector<T> result;
+    result.Reserve(count);
+    ForEachSelected(vec, mask, [&result](const T& value) {
+        result.EmplaceBack(value);
+    });
+    return result;
+}
+
+// Свёртка выбранных элементов: acc = op(acc, vec[row]) для каждого номера
+template <typename T, typename Acc, typename Op>
+Acc ReduceSelected(const Vector<T>& vec, const Vector<uint32_t>& selection, Acc init, Op&& op) {
+    for (uint32_t row : selection) {
+        init = op(std::move(init), vec[row]);
+    }
+    return init;
+}
+
+// Свёртка элементов, отмеченных в битовой маске
+template <typename T, typename Acc, typename Op>
+Acc ReduceSelected(const Vector<T>& vec, const Vector<uint64_t>& mask, Acc init, Op&& op) {
+    ForEachSelected(vec, mask, [&](const T& value) {
+        init = op(std::move(init), value);
+    });
+    return init;
+}
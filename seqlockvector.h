@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "rawmemory.h"
+#include "vector.h"
+
+// Вектор фиксированной ёмкости для одного писателя и многих читателей.
+// Писатель изменяет данные на месте, увеличивая счётчик версии до и после
+// записи; читатели не блокируются и повторяют чтение, если застали запись
+template <typename T>
+class SeqlockVector {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                  "Readers copy racily, so elements must be trivially copyable");
+
+public:
+    explicit SeqlockVector(size_t capacity)
+            : data_(capacity) {
+        std::uninitialized_value_construct_n(data_.GetAddress(), capacity);
+    }
+
+    SeqlockVector(const SeqlockVector&) = delete;
+    SeqlockVector& operator=(const SeqlockVector&) = delete;
+
+    // Методы писателя
+
+    // Вызывает func(std::span<T>) для изменения текущих элементов на месте
+    template <typename Func>
+    void Write(Func&& func) {
+        WriteGuard guard(*this);
+        func(std::span<T>(data_.GetAddress(), size_.load(std::memory_order_relaxed)));
+    }
+
+    void Store(size_t index, const T& value) {
+        assert(index < size_.load(std::memory_order_relaxed));
+        WriteGuard guard(*this);
+        data_[index] = value;
+    }
+
+    // Заменяет содержимое копией values
+    void Assign(const Vector<T>& values) {
+        if (values.Size() > data_.Capacity()) {
+            throw std::length_error("SeqlockVector capacity exceeded");
+        }
+        WriteGuard guard(*this);
+        std::copy(values.begin(), values.end(), data_.GetAddress());
+        size_.store(values.Size(), std::memory_order_relaxed);
+    }
+
+    // Методы читателей
+
+    // Вызывает func(std::span<const T>) до тех пор, пока чтение не пройдёт без
+    // параллельной записи, и возвращает результат удачной попытки. Во время
+    // неудачных попыток func может увидеть несогласованные данные, поэтому она
+    // должна только читать и не иметь побочных эффектов
+    template <typename Func>
+    auto ReadConsistent(Func&& func) const {
+        using Result = std::invoke_result_t<Func&, std::span<const T>>;
+        while (true) {
+            uint64_t version = seq_.load(std::memory_order_acquire);
+            if (version & 1) {
+                continue;
+            }
+            std::span<const T> view(data_.GetAddress(), size_.load(std::memory_order_relaxed));
+            if constexpr (std::is_void_v<Result>) {
+                func(view);
+                if (Validate(version)) {
+                    return;
+                }
+            } else {
+                Result result = func(view);
+                if (Validate(version)) {
+                    return result;
+                }
+            }
+        }
+    }
+
+    // Копирует согласованный снимок содержимого в out
+    void Read(Vector<T>& out) const {
+        ReadConsistent([&out](std::span<const T> view) {
+            out.ResizeForOverwrite(view.size());
+            std::copy(view.begin(), view.end(), out.begin());
+        });
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+private:
+    // Нечётная версия означает, что идёт запись
+    class WriteGuard {
+    public:
+        explicit WriteGuard(SeqlockVector& vec) noexcept
+                : vec_(vec)
+                , version_(vec.seq_.load(std::memory_order_relaxed)) {
+            vec_.seq_.store(version_ + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        WriteGuard(const WriteGuard&) = delete;
+        WriteGuard& operator=(const WriteGuard&) = delete;
+
+        ~WriteGuard() {
+            vec_.seq_.store(version_ + 2, std::memory_order_release);
+        }
+
+    private:
+        SeqlockVector& vec_;
+        uint64_t version_;
+    };
+
+    bool Validate(uint64_t version) const noexcept {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return seq_.load(std::memory_order_relaxed) == version;
+    }
+
+    // Счётчик версии на отдельной кеш-линии от данных
+    alignas(64) std::atomic<uint64_t> seq_ = 0;
+    std::atomic<size_t> size_ = 0;
+    RawMemory<T> data_;
+};
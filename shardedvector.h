@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Вектор, разбитый на шарды по потокам: каждый поток дописывает в свой шард
+// без синхронизации, а Collect собирает всё в один вектор точного размера
+template <typename T>
+class ShardedVector {
+public:
+    explicit ShardedVector(size_t shard_count)
+            : shards_(shard_count) {
+    }
+
+    // Вызывается только потоком, которому принадлежит шард
+    template <typename Val>
+    void Append(size_t shard, Val&& value) {
+        shards_[shard].data.PushBack(std::forward<Val>(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(size_t shard, Args&&... args) {
+        return shards_[shard].data.EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    Vector<T>& Shard(size_t shard) noexcept {
+        return shards_[shard].data;
+    }
+
+    const Vector<T>& Shard(size_t shard) const noexcept {
+        return shards_[shard].data;
+    }
+
+    [[nodiscard]] size_t ShardCount() const noexcept {
+        return shards_.Size();
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        size_t size = 0;
+        for (const Padded& shard : shards_) {
+            size += shard.data.Size();
+        }
+        return size;
+    }
+
+    // Обходит элементы всех шардов по порядку без копирования
+    template <typename Func>
+    void ForEach(Func&& func) {
+        for (Padded& shard : shards_) {
+            for (T& value : shard.data) {
+                func(value);
+            }
+        }
+    }
+
+    template <typename Func>
+    void ForEach(Func&& func) const {
+        for (const Padded& shard : shards_) {
+            for (const T& value : shard.data) {
+                func(value);
+            }
+        }
+    }
+
+    // Переносит содержимое шардов в один вектор и освобождает их память.
+    // Вызывается, когда потоки-писатели завершили работу. Для тривиальных типов
+    // шарды копируются параллельно, каждый в свой участок результата; потоков
+    // не больше, чем аппаратных, и один из них — вызывающий
+    Vector<T> Collect() {
+        const size_t total = Size();
+        Vector<T> result;
+
+        if constexpr (std::is_trivial_v<T>) {
+            result.ResizeForOverwrite(total);
+
+            Vector<size_t> offsets(shards_.Size());
+            for (size_t shard = 0, offset = 0; shard < shards_.Size(); ++shard) {
+                offsets[shard] = offset;
+                offset += shards_[shard].data.Size();
+            }
+            // Поток first копирует шарды first, first + step, ...
+            auto copy_shards = [this, &result, &offsets](size_t first, size_t step) {
+                for (size_t shard = first; shard < shards_.Size(); shard += step) {
+                    Vector<T>& data = shards_[shard].data;
+                    if (data.Size() > 0) {
+                        std::memcpy(result.begin() + offsets[shard], data.begin(), data.Size() * sizeof(T));
+                    }
+                    data = Vector<T>();
+                }
+            };
+
+            size_t threads = 1;
+            if (total * sizeof(T) >= PARALLEL_COPY_BYTES) {
+                threads = std::min<size_t>(shards_.Size(), std::max(1u, std::thread::hardware_concurrency()));
+            }
+            Vector<std::thread> workers;
+            workers.Reserve(threads - 1);
+            // Если поток не удалось запустить, его шарды копирует вызывающий поток,
+            // а уже запущенные потоки присоединяются как обычно
+            size_t started = 1;
+            try {
+                for (; started < threads; ++started) {
+                    workers.EmplaceBack(copy_shards, started, threads);
+                }
+            } catch (const std::system_error&) {
+            }
+            copy_shards(0, threads);
+            for (size_t t = started; t < threads; ++t) {
+                copy_shards(t, threads);
+            }
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+        } else {
+            result.Reserve(total);
+            for (Padded& shard : shards_) {
+                for (T& value : shard.data) {
+                    result.EmplaceBack(std::move(value));
+                }
+                shard.data = Vector<T>();
+            }
+        }
+
+        return result;
+    }
+
+private:
+    // Начиная с этого объёма копирование шардов распараллеливается
+    static constexpr size_t PARALLEL_COPY_BYTES = size_t{1} << 20;
+
+    // Каждый шард занимает собственную кеш-линию, чтобы писатели не мешали друг другу
+    struct alignas(64) Padded {
+        Vector<T> data;
+    };
+
+    Vector<Padded> shards_;
+};
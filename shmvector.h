@@ -0,0 +1,305 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace detail {
+
+inline constexpr uint64_t SHM_MAGIC = 0x5348'4D56'4543'0001;  // "SHMVEC", версия 1
+
+// Заголовок сегмента. Хранит только смещения, поэтому сегмент можно
+// отобразить в разные процессы по разным адресам
+struct ShmHeader {
+    uint64_t magic;
+    uint64_t element_size;
+    uint64_t capacity;
+    // Смещение данных от начала сегмента
+    uint64_t data_offset;
+    std::atomic<uint64_t> size;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared size counter must be lock-free");
+
+[[noreturn]] inline void ThrowErrno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Отображение сегмента разделяемой памяти вместе с его дескриптором
+class ShmSegment {
+public:
+    ShmSegment() = default;
+
+    ShmSegment(int fd, size_t length, bool writable)
+            : fd_(fd)
+            , length_(length) {
+        int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* addr = mmap(nullptr, length, prot, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            ThrowErrno("mmap");
+        }
+        addr_ = addr;
+    }
+
+    ShmSegment(const ShmSegment&) = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+
+    ShmSegment(ShmSegment&& other) noexcept
+            : fd_(std::exchange(other.fd_, -1))
+            , addr_(std::exchange(other.addr_, nullptr))
+            , length_(std::exchange(other.length_, 0)) {
+    }
+
+    ShmSegment& operator=(ShmSegment&& other) noexcept {
+        if (this != &other) {
+            ShmSegment temp(std::move(other));
+            std::swap(fd_, temp.fd_);
+            std::swap(addr_, temp.addr_);
+            std::swap(length_, temp.length_);
+        }
+        return *this;
+    }
+
+    ~ShmSegment() {
+        if (addr_ != nullptr) {
+            munmap(addr_, length_);
+        }
+        if (fd_ != -1) {
+            close(fd_);
+        }
+    }
+
+    [[nodiscard]] int Fd() const noexcept {
+        return fd_;
+    }
+
+    [[nodiscard]] void* Address() const noexcept {
+        return addr_;
+    }
+
+private:
+    int fd_ = -1;
+    void* addr_ = nullptr;
+    size_t length_ = 0;
+};
+
+template <typename T>
+constexpr uint64_t ShmDataOffset() {
+    constexpr uint64_t align = alignof(T) > 64 ? alignof(T) : 64;
+    return (sizeof(ShmHeader) + align - 1) / align * align;
+}
+
+inline size_t FileSize(int fd) {
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        ThrowErrno("fstat");
+    }
+    return static_cast<size_t>(st.st_size);
+}
+
+}  // namespace detail
+
+// Вектор фиксированной ёмкости в разделяемой памяти для передачи данных между
+// процессами без копирования. Писатель один; размер публикуется атомарно,
+// поэтому читатели видят только полностью записанные элементы
+template <typename T>
+class ShmVector {
+    static_assert(std::is_trivially_copyable_v<T>, "Shared memory elements must be trivially copyable");
+
+public:
+    // Создаёт именованный сегмент POSIX (shm_open). Имя должно начинаться с '/'
+    static ShmVector Create(const std::string& name, size_t capacity) {
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd == -1) {
+            detail::ThrowErrno("shm_open");
+        }
+        return ShmVector(fd, capacity, name);
+    }
+
+#ifdef __linux__
+    // Создаёт безымянный сегмент (memfd_create). Дескриптор Fd() можно передать
+    // другому процессу через fork или SCM_RIGHTS
+    static ShmVector CreateAnonymous(size_t capacity) {
+        int fd = memfd_create("shm_vector", MFD_CLOEXEC);
+        if (fd == -1) {
+            detail::ThrowErrno("memfd_create");
+        }
+        return ShmVector(fd, capacity, {});
+    }
+#endif
+
+    // Удаляет имя сегмента; уже открытые отображения продолжают работать
+    void Unlink() {
+        if (!name_.empty()) {
+            shm_unlink(name_.c_str());
+            name_.clear();
+        }
+    }
+
+    template <typename Val>
+    void PushBack(Val&& value) {
+        uint64_t size = header_->size.load(std::memory_order_relaxed);
+        if (size == header_->capacity) {
+            throw std::length_error("ShmVector capacity exceeded");
+        }
+        std::construct_at(data_ + size, std::forward<Val>(value));
+        header_->size.store(size + 1, std::memory_order_release);
+    }
+
+    // Изменение уже опубликованных элементов не синхронизировано с читателями
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return data_[index];
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return data_[index];
+    }
+
+    const T* begin() const noexcept {
+        return data_;
+    }
+
+    const T* end() const noexcept {
+        return data_ + Size();
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return header_->size.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t Capacity() const noexcept {
+        return header_->capacity;
+    }
+
+    [[nodiscard]] int Fd() const noexcept {
+        return segment_.Fd();
+    }
+
+private:
+    ShmVector(int fd, size_t capacity, std::string name)
+            : name_(std::move(name)) {
+        // Созданное имя не должно пережить неудачное создание вектора
+        try {
+            // Длина сегмента должна помещаться и в size_t, и в off_t для ftruncate
+            constexpr size_t max_length = static_cast<size_t>(std::numeric_limits<off_t>::max());
+            if (capacity > (max_length - detail::ShmDataOffset<T>()) / sizeof(T)) {
+                close(fd);
+                throw std::length_error("ShmVector capacity is too large");
+            }
+            const size_t length = detail::ShmDataOffset<T>() + capacity * sizeof(T);
+            if (ftruncate(fd, static_cast<off_t>(length)) != 0) {
+                int error = errno;
+                close(fd);
+                errno = error;
+                detail::ThrowErrno("ftruncate");
+            }
+            segment_ = detail::ShmSegment(fd, length, true);
+        } catch (...) {
+            Unlink();
+            throw;
+        }
+
+        auto* base = static_cast<std::byte*>(segment_.Address());
+        header_ = std::construct_at(reinterpret_cast<detail::ShmHeader*>(base), detail::SHM_MAGIC, sizeof(T),
+                                    capacity, detail::ShmDataOffset<T>(), 0);
+        data_ = reinterpret_cast<T*>(base + header_->data_offset);
+    }
+
+    std::string name_;
+    detail::ShmSegment segment_;
+    detail::ShmHeader* header_ = nullptr;
+    T* data_ = nullptr;
+};
+
+// Отображение ShmVector другого процесса только для чтения
+template <typename T>
+class ShmVectorView {
+public:
+    static ShmVectorView Open(const std::string& name) {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd == -1) {
+            detail::ThrowErrno("shm_open");
+        }
+        return ShmVectorView(fd);
+    }
+
+    // Принимает владение дескриптором fd
+    static ShmVectorView FromFd(int fd) {
+        return ShmVectorView(fd);
+    }
+
+    // Доступны только опубликованные элементы: index < Size()
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return data_[index];
+    }
+
+    const T* begin() const noexcept {
+        return data_;
+    }
+
+    // Элементы до end() опубликованы писателем и полностью видны
+    const T* end() const noexcept {
+        return data_ + Size();
+    }
+
+    // Размер ограничен ёмкостью: заголовок записан другим процессом,
+    // и end() не должен выходить за пределы отображения
+    [[nodiscard]] size_t Size() const noexcept {
+        const uint64_t size = header_->size.load(std::memory_order_acquire);
+        return size < header_->capacity ? static_cast<size_t>(size) : static_cast<size_t>(header_->capacity);
+    }
+
+    [[nodiscard]] size_t Capacity() const noexcept {
+        return header_->capacity;
+    }
+
+private:
+    explicit ShmVectorView(int fd) {
+        size_t length;
+        try {
+            length = detail::FileSize(fd);
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        if (length < sizeof(detail::ShmHeader)) {
+            close(fd);
+            throw std::runtime_error("Shared memory segment is too small");
+        }
+        segment_ = detail::ShmSegment(fd, length, false);
+
+        const auto* base = static_cast<const std::byte*>(segment_.Address());
+        header_ = reinterpret_cast<const detail::ShmHeader*>(base);
+        // Проверки без переполнения: заголовок мог записать недоверенный процесс
+        if (header_->magic != detail::SHM_MAGIC || header_->element_size != sizeof(T)
+            || header_->data_offset < sizeof(detail::ShmHeader) || header_->data_offset > length
+            || header_->data_offset % alignof(T) != 0
+            || header_->capacity > (length - header_->data_offset) / sizeof(T)) {
+            throw std::runtime_error("Shared memory segment does not hold a ShmVector of this type");
+        }
+        data_ = reinterpret_cast<const T*>(base + header_->data_offset);
+    }
+
+    detail::ShmSegment segment_;
+    const detail::ShmHeader* header_ = nullptr;
+    const T* data_ = nullptr;
+};
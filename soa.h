@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define VECTOR_SOA_AVX2 1
+#endif
+
+namespace detail {
+
+template <typename Record, typename... Columns>
+constexpr void CheckRecordLayout() {
+    static_assert(sizeof...(Columns) > 0, "At least one column is required");
+    static_assert(std::is_trivially_copyable_v<Record> && (std::is_trivially_copyable_v<Columns> && ...),
+                  "Records and columns must be trivially copyable");
+    static_assert(sizeof(Record) == (sizeof(Columns) + ...),
+                  "Record must consist of the column types without padding");
+}
+
+template <typename... Columns>
+constexpr std::array<size_t, sizeof...(Columns)> FieldOffsets() {
+    std::array<size_t, sizeof...(Columns)> offsets{};
+    const size_t sizes[] = {sizeof(Columns)...};
+    size_t offset = 0;
+    for (size_t i = 0; i < sizeof...(Columns); ++i) {
+        offsets[i] = offset;
+        offset += sizes[i];
+    }
+    return offsets;
+}
+
+// Один проход по записям, все поля строки за раз. Строка читается один раз,
+// а каждый столбец пишется последовательно
+template <typename Record, size_t... Is, typename... Columns>
+void SplitRows(const Record* rows, size_t first, size_t last, std::index_sequence<Is...>, Columns*... columns) {
+    constexpr auto offsets = FieldOffsets<Columns...>();
+    const auto* in = reinterpret_cast<const std::byte*>(rows);
+    for (size_t i = first; i < last; ++i) {
+        (std::memcpy(columns + i, in + i * sizeof(Record) + offsets[Is], sizeof(Columns)), ...);
+    }
+}
+
+template <typename Record, size_t... Is, typename... Columns>
+void InterleaveRows(Record* rows, size_t first, size_t last, std::index_sequence<Is...>, const Columns*... columns) {
+    constexpr auto offsets = FieldOffsets<Columns...>();
+    auto* out = reinterpret_cast<std::byte*>(rows);
+    for (size_t i = first; i < last; ++i) {
+        (std::memcpy(out + i * sizeof(Record) + offsets[Is], columns + i, sizeof(Columns)), ...);
+    }
+}
+
+#ifdef VECTOR_SOA_AVX2
+
+// Таблицы перестановок для записей из N полей по W байт (W = 4 или 8).
+// За шаг обрабатывается L = 32 / W записей, то есть ровно N регистров по 32 байта.
+// Индексы даны в 32-битных словах для _mm256_permutevar8x32_epi32, который
+// берёт позицию по модулю 8, поэтому один индекс годится для всех регистров;
+// маска смешивания выбирает, из какого регистра берётся каждое слово
+template <size_t N, size_t W>
+struct TransposeTables {
+    static constexpr size_t WORDS = W / 4;
+    static constexpr size_t L = 8 / WORDS;
+
+    using Lanes = std::array<int32_t, 8>;
+
+    // Для Split: в регистре s слово записи r поля f лежит на позиции (N * r + f) % L.
+    // Для Interleave: слово j выходного регистра s — поле (L * s + j) % N записи (L * s + j) / N
+    static constexpr std::array<Lanes, N> Index(bool split) {
+        std::array<Lanes, N> index{};
+        for (size_t v = 0; v < N; ++v) {
+            for (size_t j = 0; j < L; ++j) {
+                const size_t pos = split ? (N * j + v) % L : (L * v + j) / N;
+                for (size_t t = 0; t < WORDS; ++t) {
+                    index[v][j * WORDS + t] = static_cast<int32_t>(pos * WORDS + t);
+                }
+            }
+        }
+        return index;
+    }
+
+    // blend[v][u]: биты слов результата v, которые берутся из входного регистра u
+    static constexpr std::array<std::array<int, N>, N> Blend(bool split) {
+        std::array<std::array<int, N>, N> blend{};
+        for (size_t v = 0; v < N; ++v) {
+            for (size_t j = 0; j < L; ++j) {
+                const size_t u = split ? (N * j + v) / L : (L * v + j) % N;
+                for (size_t t = 0; t < WORDS; ++t) {
+                    blend[v][u] |= 1 << (j * WORDS + t);
+                }
+            }
+        }
+        return blend;
+    }
+
+    static constexpr auto split_index = Index(true);
+    static constexpr auto split_blend = Blend(true);
+    static constexpr auto interleave_index = Index(false);
+    static constexpr auto interleave_blend = Blend(false);
+};
+
+template <int Mask>
+__attribute__((target("avx2"), always_inline)) inline __m256i BlendLanes(__m256i a, __m256i b) noexcept {
+    return _mm256_blend_epi32(a, b, Mask);
+}
+
+// Собирает регистр результата V из N входных: N перестановок и N - 1 смешиваний
+// с масками-константами
+template <const auto& Index, const auto& Blend, size_t V, size_t... Us>
+__attribute__((target("avx2"), always_inline)) inline __m256i GatherLanes(const __m256i (&in)[sizeof...(Us) + 1],
+                                                                          std::index_sequence<0, Us...>) noexcept {
+    const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Index[V].data()));
+    __m256i out = _mm256_permutevar8x32_epi32(in[0], index);
+    ((out = BlendLanes<Blend[V][Us]>(out, _mm256_permutevar8x32_epi32(in[Us], index))), ...);
+    return out;
+}
+
+// Все обращения к регистрам развёрнуты по пакетам индексов, чтобы in не
+// попадал в стек: иначе загрузка половинами и чтение целиком срывают
+// пересылку из буфера записи
+template <size_t N, size_t W, size_t... Is>
+__attribute__((target("avx2"))) size_t SplitAvx2(const std::byte* rows, size_t count,
+                                                 std::array<std::byte*, N> columns,
+                                                 std::index_sequence<Is...> fields) noexcept {
+    using Tables = TransposeTables<N, W>;
+    size_t i = 0;
+    for (; i + Tables::L <= count; i += Tables::L) {
+        const std::byte* src = rows + i * N * W;
+        const __m256i in[N] = {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + Is * 32))...};
+        (_mm256_storeu_si256(reinterpret_cast<__m256i*>(columns[Is] + i * W),
+                             GatherLanes<Tables::split_index, Tables::split_blend, Is>(in, fields)),
+         ...);
+    }
+    return i;
+}
+
+template <size_t N, size_t W, size_t... Is>
+__attribute__((target("avx2"))) size_t InterleaveAvx2(std::byte* rows, size_t count,
+                                                      std::array<const std::byte*, N> columns,
+                                                      std::index_sequence<Is...> fields) noexcept {
+    using Tables = TransposeTables<N, W>;
+    size_t i = 0;
+    for (; i + Tables::L <= count; i += Tables::L) {
+        std::byte* dst = rows + i * N * W;
+        const __m256i in[N] = {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns[Is] + i * W))...};
+        (_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + Is * 32),
+                             GatherLanes<Tables::interleave_index, Tables::interleave_blend, Is>(in, fields)),
+         ...);
+    }
+    return i;
+}
+
+// Перестановочные ядра есть для 2-4 полей одинакового размера 4 или 8 байт
+template <typename... Columns>
+constexpr bool HasTransposeKernel() {
+    constexpr size_t n = sizeof...(Columns);
+    constexpr size_t sizes[] = {sizeof(Columns)...};
+    return n >= 2 && n <= 4 && (sizes[0] == 4 || sizes[0] == 8) && ((sizeof(Columns) == sizes[0]) && ...);
+}
+
+inline bool HasAvx2() noexcept {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+#endif
+
+template <typename Record, typename... Columns>
+void SplitColumns(const Vector<Record>& rows, Vector<Columns>&... columns) {
+    size_t done = 0;
+#ifdef VECTOR_SOA_AVX2
+    if constexpr (HasTransposeKernel<Columns...>()) {
+        if (HasAvx2()) {
+            constexpr size_t n = sizeof...(Columns);
+            const std::array<std::byte*, n> out{reinterpret_cast<std::byte*>(columns.begin())...};
+            done = SplitAvx2<n, sizeof(Record) / n>(reinterpret_cast<const std::byte*>(rows.begin()), rows.Size(), out,
+                                                    std::make_index_sequence<n>{});
+        }
+    }
+#endif
+    SplitRows(rows.begin(), done, rows.Size(), std::index_sequence_for<Columns...>{}, columns.begin()...);
+}
+
+template <typename Record, typename... Columns>
+void InterleaveColumns(Vector<Record>& rows, const Vector<Columns>&... columns) {
+    size_t done = 0;
+#ifdef VECTOR_SOA_AVX2
+    if constexpr (HasTransposeKernel<Columns...>()) {
+        if (HasAvx2()) {
+            constexpr size_t n = sizeof...(Columns);
+            const std::array<const std::byte*, n> in{reinterpret_cast<const std::byte*>(columns.begin())...};
+            done = InterleaveAvx2<n, sizeof(Record) / n>(reinterpret_cast<std::byte*>(rows.begin()), rows.Size(), in,
+                                                         std::make_index_sequence<n>{});
+        }
+    }
+#endif
+    InterleaveRows(rows.begin(), done, rows.Size(), std::index_sequence_for<Columns...>{}, columns.begin()...);
+}
+
+}  // namespace detail
+
+// Раскладывает массив записей по столбцам. Поля Record должны идти в порядке
+// Columns без выравнивающих промежутков
+template <typename Record, typename... Columns>
+void Split(const Vector<Record>& rows, Vector<Columns>&... columns) {
+    detail::CheckRecordLayout<Record, Columns...>();
+    (columns.ResizeForOverwrite(rows.Size()), ...);
+    detail::SplitColumns(rows, columns...);
+}
+
+// Обратное к Split преобразование: собирает записи из столбцов одинаковой длины
+template <typename Record, typename... Columns>
+void Interleave(Vector<Record>& rows, const Vector<Columns>&... columns) {
+    detail::CheckRecordLayout<Record, Columns...>();
+    const size_t sizes[] = {columns.Size()...};
+    if (!std::all_of(std::begin(sizes), std::end(sizes), [&](size_t size) {
+            return size == sizes[0];
+        })) {
+        throw std::invalid_argument("Columns must have equal sizes");
+    }
+
+    rows.ResizeForOverwrite(sizes[0]);
+    detail::InterleaveColumns(rows, columns...);
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+#include "vector.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define VECTOR_SPLIT_AVX2 1
+#endif
+
+namespace detail {
+
+// Резервирует место ещё под extra смещений, увеличивая ёмкость геометрически
+template <typename Offset>
+Offset* GrowOffsets(Vector<Offset>& out, size_t count, size_t extra) {
+    if (count + extra > out.Capacity()) {
+        out.Reserve(std::max(count + extra, out.Capacity() * 2));
+    }
+    out.ResizeForOverwrite(count + extra);
+    return out.begin() + count;
+}
+
+// Дописывает в out позиции delim в [first, last), используя memchr
+template <typename Offset>
+void ScanDelimitersScalar(const char* data, size_t first, size_t last, char delim, Vector<Offset>& out) {
+    const char* pos = data + first;
+    const char* end = data + last;
+    while (pos < end) {
+        const void* found = std::memchr(pos, delim, end - pos);
+        if (found == nullptr) {
+            break;
+        }
+        pos = static_cast<const char*>(found);
+        out.PushBack(static_cast<Offset>(pos - data));
+        ++pos;
+    }
+}
+
+#ifdef VECTOR_SPLIT_AVX2
+
+// Сравнивает по 64 байта за шаг: два 32-байтовых сравнения дают 64-битную маску,
+// из которой позиции извлекаются подсчётом младших нулей
+template <typename Offset>
+__attribute__((target("avx2,bmi"))) void ScanDelimitersAvx2(const char* data, size_t first, size_t last, char delim,
+                                                          Vector<Offset>& out) {
+    const __m256i needle = _mm256_set1_epi8(delim);
+    size_t count = out.Size();
+    size_t pos = first;
+    for (; pos + 64 <= last; pos += 64) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 32));
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)))
+                        | static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle))))
+                                  << 32;
+        if (mask == 0) {
+            continue;
+        }
+        Offset* dst = GrowOffsets(out, count, std::popcount(mask));
+        for (; mask != 0; mask &= mask - 1) {
+            *dst++ = static_cast<Offset>(pos + std::countr_zero(mask));
+        }
+        count = out.Size();
+    }
+    ScanDelimitersScalar(data, pos, last, delim, out);
+}
+
+#endif
+
+template <typename Offset>
+void ScanDelimiters(const char* data, size_t first, size_t last, char delim, Vector<Offset>& out) {
+#ifdef VECTOR_SPLIT_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi");
+    if (has_avx2) {
+        ScanDelimitersAvx2(data, first, last, delim, out);
+        return;
+    }
+#endif
+    ScanDelimitersScalar(data, first, last, delim, out);
+}
+
+}  // namespace detail
+
+// Позиции всех вхождений delim в text за один проход. Запись k занимает
+// байты между позициями k-1 и k. Offset может быть uint32_t для буферов до 4 ГиБ
+template <typename Offset = uint64_t>
+Vector<Offset> SplitOffsets(std::string_view text, char delim) {
+    Vector<Offset> offsets;
+    detail::ScanDelimiters(text.data(), 0, text.size(), delim, offsets);
+    return offsets;
+}
+
+template <typename Offset = uint64_t>
+Vector<Offset> SplitOffsets(const Vector<char>& text, char delim) {
+    return SplitOffsets<Offset>(std::string_view(text.begin(), text.Size()), delim);
+}
+
+// Параллельный вариант: буфер делится на участки по числу потоков, каждый
+// участок сканируется независимо, результаты склеиваются по порядку. Позиции
+// абсолютные, поэтому записи, пересекающие границу участков, не требуют
+// отдельной обработки
+template <typename Offset = uint64_t>
+Vector<Offset> SplitOffsetsParallel(const Vector<char>& text, char delim, size_t threads = 0) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Мелкие участки не окупают запуск потоков
+    constexpr size_t MIN_CHUNK = size_t{1} << 20;
+    threads = std::clamp<size_t>(text.Size() / MIN_CHUNK, 1, threads);
+    if (threads == 1) {
+        return SplitOffsets<Offset>(text, delim);
+    }
+
+    const size_t chunk = (text.Size() + threads - 1) / threads;
+    Vector<Vector<Offset>> parts(threads);
+    {
+        Vector<std::thread> workers;
+        workers.Reserve(threads);
+        // Уже запущенные потоки присоединяются и тогда, когда запуск следующего
+        // выбросил исключение: деструктор joinable std::thread вызывает std::terminate
+        struct JoinAll {
+            Vector<std::thread>& workers;
+
+            ~JoinAll() {
+                for (std::thread& worker : workers) {
+                    worker.join();
+                }
+            }
+        } join_all{workers};
+        for (size_t t = 0; t < threads; ++t) {
+            workers.EmplaceBack([&, t] {
+                size_t first = std::min(t * chunk, text.Size());
+                size_t last = std::min(first + chunk, text.Size());
+                detail::ScanDelimiters(text.begin(), first, last, delim, parts[t]);
+            });
+        }
+    }
+
+    size_t total = 0;
+    for (const Vector<Offset>& part : parts) {
+        total += part.Size();
+    }
+    Vector<Offset> offsets;
+    offsets.ResizeForOverwrite(total);
+    Offset* dst = offsets.begin();
+    for (const Vector<Offset>& part : parts) {
+        std::copy(part.begin(), part.end(), dst);
+        dst += part.Size();
+    }
+    return offsets;
+}
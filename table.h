@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+#include "selection.h"
+#include "vector.h"
+
+// Строковый столбец: байты всех строк подряд и смещения концов строк
+class StringColumn {
+public:
+    void PushBack(std::string_view value) {
+        const size_t old_size = bytes_.Size();
+        if (old_size + value.size() > bytes_.Capacity()) {
+            bytes_.Reserve(std::max(old_size + value.size(), bytes_.Capacity() * 2));
+        }
+        bytes_.ResizeForOverwrite(old_size + value.size());
+        if (!value.empty()) {
+            std::memcpy(bytes_.begin() + old_size, value.data(), value.size());
+        }
+        ends_.PushBack(bytes_.Size());
+    }
+
+    std::string_view operator[](size_t index) const noexcept {
+        const uint64_t begin = index == 0 ? 0 : ends_[index - 1];
+        return {bytes_.begin() + begin, static_cast<size_t>(ends_[index] - begin)};
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return ends_.Size();
+    }
+
+private:
+    Vector<char> bytes_;
+    Vector<uint64_t> ends_;
+};
+
+// Столбец со словарным кодированием: строки хранятся один раз в словаре,
+// а для каждой строки таблицы — 32-битный код. Словарь неизменяем и разделяется
+// столбцами, полученными через WithCodes; PushBack копирует его, только если
+// он разделён и нужно добавить новое значение
+class DictionaryColumn {
+public:
+    DictionaryColumn() = default;
+    DictionaryColumn(const DictionaryColumn&) = default;
+    DictionaryColumn& operator=(const DictionaryColumn&) = default;
+
+    // Перемещённый столбец сохраняет ссылку на словарь, чтобы dictionary_ никогда не был пустым
+    DictionaryColumn(DictionaryColumn&& other) noexcept
+            : codes_(std::move(other.codes_))
+            , dictionary_(other.dictionary_) {
+    }
+
+    DictionaryColumn& operator=(DictionaryColumn&& other) noexcept {
+        codes_ = std::move(other.codes_);
+        dictionary_ = other.dictionary_;
+        return *this;
+    }
+
+    void PushBack(std::string_view value) {
+        std::string key(value);
+        if (auto it = dictionary_->index.find(key); it != dictionary_->index.end()) {
+            codes_.PushBack(it->second);
+            return;
+        }
+        Data& data = MutableDictionary();
+        const uint32_t code = static_cast<uint32_t>(data.values.Size());
+        data.index.emplace(std::move(key), code);
+        data.values.PushBack(value);
+        codes_.PushBack(code);
+    }
+
+    std::string_view operator[](size_t index) const noexcept {
+        return dictionary_->values[codes_[index]];
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return codes_.Size();
+    }
+
+    const Vector<uint32_t>& Codes() const noexcept {
+        return codes_;
+    }
+
+    const StringColumn& Dictionary() const noexcept {
+        return dictionary_->values;
+    }
+
+    [[nodiscard]] std::optional<uint32_t> Find(std::string_view value) const {
+        auto it = dictionary_->index.find(std::string(value));
+        return it == dictionary_->index.end() ? std::nullopt : std::optional<uint32_t>(it->second);
+    }
+
+    // Столбец с тем же словарём и другими кодами; словарь не копируется
+    [[nodiscard]] DictionaryColumn WithCodes(Vector<uint32_t> codes) const {
+        DictionaryColumn result;
+        result.codes_ = std::move(codes);
+        result.dictionary_ = dictionary_;
+        return result;
+    }
+
+private:
+    struct Data {
+        StringColumn values;
+        std::unordered_map<std::string, uint32_t> index;
+    };
+
+    Data& MutableDictionary() {
+        if (dictionary_.use_count() > 1) {
+            dictionary_ = std::make_shared<Data>(*dictionary_);
+        }
+        // Словарь всегда создаётся через make_shared<Data>, то есть неконстантным
+        return const_cast<Data&>(*dictionary_);
+    }
+
+    Vector<uint32_t> codes_;
+    std::shared_ptr<const Data> dictionary_ = std::make_shared<Data>();
+};
+
+using Column = std::variant<Vector<int64_t>, Vector<double>, StringColumn, DictionaryColumn>;
+
+inline size_t ColumnSize(const Column& column) noexcept {
+    return std::visit([](const auto& values) {
+        return values.Size();
+    }, column);
+}
+
+// Таблица из именованных столбцов одинаковой длины с типом, известным во время
+// выполнения. Фильтры возвращают вектор номеров подходящих строк, а
+// материализация выполняется только для нужных столбцов в самом конце.
+// Столбцы неизменяемы и разделяются между таблицами, поэтому проекция ничего не копирует
+class Table {
+public:
+    void AddColumn(std::string name, Column column) {
+        if (FindColumn(name)) {
+            throw std::invalid_argument("Duplicate column name: " + name);
+        }
+        const size_t size = ColumnSize(column);
+        if (columns_.Size() > 0 && size != rows_) {
+            throw std::invalid_argument("Column " + name + " has a different number of rows");
+        }
+        rows_ = size;
+        names_.PushBack(std::move(name));
+        columns_.PushBack(std::make_shared<const Column>(std::move(column)));
+    }
+
+    [[nodiscard]] size_t RowCount() const noexcept {
+        return rows_;
+    }
+
+    [[nodiscard]] size_t ColumnCount() const noexcept {
+        return columns_.Size();
+    }
+
+    const Vector<std::string>& ColumnNames() const noexcept {
+        return names_;
+    }
+
+    const Column& GetColumn(std::string_view name) const {
+        return *columns_[ColumnIndex(name)];
+    }
+
+    // Столбец заданного типа; при несовпадении типа выбрасывает std::bad_variant_access
+    template <typename ColumnType>
+    const ColumnType& Get(std::string_view name) const {
+        return std::get<ColumnType>(GetColumn(name));
+    }
+
+    // Новая таблица из части столбцов, разделяющая с исходной их данные
+    Table Project(std::initializer_list<std::string_view> names) const {
+        Table result;
+        for (std::string_view name : names) {
+            size_t index = ColumnIndex(name);
+            if (result.FindColumn(name)) {
+                throw std::invalid_argument("Duplicate column name: " + std::string(name));
+            }
+            result.names_.PushBack(names_[index]);
+            result.columns_.PushBack(columns_[index]);
+        }
+        result.rows_ = result.columns_.Size() > 0 ? rows_ : 0;
+        return result;
+    }
+
+    // Номера строк, значение которых в столбце name удовлетворяет pred.
+    // pred принимает int64_t, double или std::string_view в зависимости от типа столбца
+    template <typename Pred>
+    Vector<uint32_t> Filter(std::string_view name, Pred&& pred) const {
+        return FilterRows(name, rows_, nullptr, pred);
+    }
+
+    // Сужает ранее полученную выборку ещё одним условием
+    template <typename Pred>
+    Vector<uint32_t> Filter(std::string_view name, Pred&& pred, const Vector<uint32_t>& selection) const {
+        return FilterRows(name, selection.Size(), selection.begin(), pred);
+    }
+
+    // Копирует выбранные строки одного столбца
+    Column Gather(std::string_view name, const Vector<uint32_t>& selection) const {
+        return std::visit([&selection](const auto& values) -> Column {
+            using Type = std::remove_cvref_t<decltype(values)>;
+            if constexpr (std::is_same_v<Type, StringColumn>) {
+                StringColumn result;
+                for (uint32_t row : selection) {
+                    result.PushBack(values[row]);
+                }
+                return result;
+            } else if constexpr (std::is_same_v<Type, DictionaryColumn>) {
+                return values.WithCodes(GatherSelected(values.Codes(), selection));
+            } else {
+                return GatherSelected(values, selection);
+            }
+        }, GetColumn(name));
+    }
+
+    // Поздняя материализация: таблица из выбранных строк заданных столбцов
+    Table Materialize(const Vector<uint32_t>& selection, std::initializer_list<std::string_view> names) const {
+        Table result;
+        for (std::string_view name : names) {
+            result.AddColumn(std::string(name), Gather(name, selection));
+        }
+        return result;
+    }
+
+private:
+    template <typename Pred>
+    Vector<uint32_t> FilterRows(std::string_view name, size_t count, const uint32_t* rows, Pred& pred) const {
+        return std::visit([&](const auto& values) -> Vector<uint32_t> {
+            using Type = std::remove_cvref_t<decltype(values)>;
+            if constexpr (std::is_same_v<Type, DictionaryColumn>) {
+                // Предикат вычисляется один раз на значение словаря, а строки
+                // проверяются по таблице результатов для кодов
+                const StringColumn& dictionary = values.Dictionary();
+                Vector<uint8_t> matches(dictionary.Size());
+                for (size_t code = 0; code < dictionary.Size(); ++code) {
+                    matches[code] = Invoke(pred, dictionary[code]) ? 1 : 0;
+                }
+                const uint32_t* codes = values.Codes().begin();
+                return detail::SelectRows(count, rows, [&](uint32_t row) {
+                    return matches[codes[row]] != 0;
+                });
+            } else if constexpr (std::is_same_v<Type, StringColumn>) {
+                return detail::SelectRows(count, rows, [&](uint32_t row) {
+                    return Invoke(pred, values[row]);
+                });
+            } else {
+                const auto* data = values.begin();
+                return detail::SelectRows(count, rows, [&](uint32_t row) {
+                    return Invoke(pred, data[row]);
+                });
+            }
+        }, GetColumn(name));
+    }
+
+    template <typename Pred, typename Value>
+    static bool Invoke(Pred& pred, const Value& value) {
+        if constexpr (std::is_invocable_r_v<bool, Pred&, const Value&>) {
+            return pred(value);
+        } else {
+            throw std::invalid_argument("Predicate does not accept the column type");
+        }
+    }
+
+    [[nodiscard]] std::optional<size_t> FindColumn(std::string_view name) const noexcept {
+        for (size_t i = 0; i < names_.Size(); ++i) {
+            if (names_[i] == name) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] size_t ColumnIndex(std::string_view name) const {
+        if (auto index = FindColumn(name)) {
+            return *index;
+        }
+        throw std::out_of_range("No such column: " + std::string(name));
+    }
+
+    Vector<std::string> names_;
+    Vector<std::shared_ptr<const Column>> columns_;
+    size_t rows_ = 0;
+};
@@ -0,0 +1,344 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+
+#include "vector.h"
+
+struct TimePoint {
+    int64_t timestamp = 0;
+    double value = 0.0;
+};
+
+namespace detail {
+
+// Поток битов, записываемых старшими разрядами вперёд
+class BitWriter {
+public:
+    // Записывает младшие count (1..64) бит value
+    void Write(uint64_t value, unsigned count) {
+        assert(count >= 1 && count <= 64);
+        if (count < 64) {
+            value &= (uint64_t{1} << count) - 1;
+        }
+        const unsigned used = bit_size_ % 64;
+        if (used == 0) {
+            words_.PushBack(0);
+        }
+        const unsigned free = 64 - used;
+        uint64_t& last = words_[words_.Size() - 1];
+        if (count <= free) {
+            last |= value << (free - count);
+        } else {
+            const unsigned rest = count - free;
+            last |= value >> rest;
+            words_.PushBack(value << (64 - rest));
+        }
+        bit_size_ += count;
+    }
+
+    [[nodiscard]] size_t BitSize() const noexcept {
+        return bit_size_;
+    }
+
+    const Vector<uint64_t>& Words() const noexcept {
+        return words_;
+    }
+
+private:
+    Vector<uint64_t> words_;
+    size_t bit_size_ = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint64_t* words, size_t position) noexcept
+            : words_(words)
+            , position_(position) {
+    }
+
+    // Читает count (1..64) бит
+    uint64_t Read(unsigned count) noexcept {
+        assert(count >= 1 && count <= 64);
+        const unsigned offset = position_ % 64;
+        const unsigned available = 64 - offset;
+        const uint64_t word = words_[position_ / 64];
+        uint64_t result;
+        if (count <= available) {
+            result = (word << offset) >> (64 - count);
+        } else {
+            const unsigned rest = count - available;
+            result = ((word << offset) >> offset << rest) | (words_[position_ / 64 + 1] >> (64 - rest));
+        }
+        position_ += count;
+        return result;
+    }
+
+    bool ReadBit() noexcept {
+        return Read(1) != 0;
+    }
+
+private:
+    const uint64_t* words_;
+    size_t position_;
+};
+
+// Арифметика меток по модулю 2^64: кодирование обратимо при любых разностях
+inline int64_t WrappingAdd(int64_t a, int64_t b) noexcept {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+}
+
+inline int64_t WrappingSub(int64_t a, int64_t b) noexcept {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+}
+
+inline int64_t SignExtend(uint64_t value, unsigned bits) noexcept {
+    const unsigned shift = 64 - bits;
+    return static_cast<int64_t>(value << shift) >> shift;
+}
+
+}  // namespace detail
+
+// Сжатый временной ряд в духе Gorilla. Метки времени кодируются разностью
+// второго порядка: равномерный ряд тратит 1 бит на метку. Значения кодируются
+// XOR с предыдущим: повтор стоит 1 бит, медленно меняющиеся значения — только
+// значащее окно отличающихся бит.
+//
+// Ряд разбит на блоки по BlockPoints точек; блок начинается с несжатой точки,
+// а индекс блоков {первая метка, смещение в битах} позволяет начинать
+// декодирование с любого блока. Метки времени должны не убывать
+class TimeSeriesVector {
+public:
+    struct Block {
+        int64_t first_timestamp = 0;
+        size_t bit_offset = 0;
+    };
+
+    // Последовательное декодирование с позиции Seek или Begin. Добавление
+    // точек в ряд делает курсоры недействительными
+    class Cursor {
+    public:
+        [[nodiscard]] bool Valid() const noexcept {
+            return index_ < series_->size_;
+        }
+
+        const TimePoint& Point() const noexcept {
+            assert(Valid());
+            return point_;
+        }
+
+        // Номер текущей точки в ряду
+        [[nodiscard]] size_t Index() const noexcept {
+            return index_;
+        }
+
+        void Advance() noexcept {
+            ++index_;
+            if (Valid()) {
+                Decode();
+            }
+        }
+
+    private:
+        friend class TimeSeriesVector;
+
+        Cursor(const TimeSeriesVector* series, size_t block) noexcept
+                : series_(series)
+                , reader_(series->bits_.Words().begin(), series->BlockOffset(block))
+                , index_(block * series->block_points_) {
+            if (Valid()) {
+                Decode();
+            }
+        }
+
+        void Decode() noexcept {
+            if (index_ % series_->block_points_ == 0) {
+                point_.timestamp = static_cast<int64_t>(reader_.Read(64));
+                value_bits_ = reader_.Read(64);
+                delta_ = 0;
+                leading_ = NO_WINDOW;
+            } else {
+                delta_ = detail::WrappingAdd(delta_, DecodeDelta());
+                point_.timestamp = detail::WrappingAdd(point_.timestamp, delta_);
+                value_bits_ ^= DecodeXor();
+            }
+            point_.value = std::bit_cast<double>(value_bits_);
+        }
+
+        int64_t DecodeDelta() noexcept {
+            if (!reader_.ReadBit()) {
+                return 0;
+            }
+            for (const auto& [bits, prefix] : DOD_BUCKETS) {
+                if (!reader_.ReadBit()) {
+                    return detail::SignExtend(reader_.Read(bits), bits);
+                }
+            }
+            return static_cast<int64_t>(reader_.Read(64));
+        }
+
+        uint64_t DecodeXor() noexcept {
+            if (!reader_.ReadBit()) {
+                return 0;
+            }
+            if (reader_.ReadBit()) {
+                leading_ = static_cast<unsigned>(reader_.Read(6));
+                trailing_ = 64 - leading_ - (static_cast<unsigned>(reader_.Read(6)) + 1);
+            }
+            return reader_.Read(64 - leading_ - trailing_) << trailing_;
+        }
+
+        const TimeSeriesVector* series_;
+        detail::BitReader reader_;
+        size_t index_;
+        TimePoint point_;
+        int64_t delta_ = 0;
+        uint64_t value_bits_ = 0;
+        unsigned leading_ = NO_WINDOW;
+        unsigned trailing_ = 0;
+    };
+
+    explicit TimeSeriesVector(size_t block_points = 256)
+            : block_points_(block_points) {
+        if (block_points == 0) {
+            throw std::invalid_argument("Block must contain at least one point");
+        }
+    }
+
+    void Append(int64_t timestamp, double value) {
+        if (size_ > 0 && timestamp < timestamp_) {
+            throw std::invalid_argument("Timestamps must not decrease");
+        }
+        const uint64_t value_bits = std::bit_cast<uint64_t>(value);
+        if (size_ % block_points_ == 0) {
+            blocks_.PushBack(Block{timestamp, bits_.BitSize()});
+            bits_.Write(static_cast<uint64_t>(timestamp), 64);
+            bits_.Write(value_bits, 64);
+            delta_ = 0;
+            leading_ = NO_WINDOW;
+        } else {
+            const int64_t delta = detail::WrappingSub(timestamp, timestamp_);
+            EncodeDelta(detail::WrappingSub(delta, delta_));
+            EncodeXor(value_bits ^ value_bits_);
+            delta_ = delta;
+        }
+        timestamp_ = timestamp;
+        value_bits_ = value_bits;
+        ++size_;
+    }
+
+    void Append(const TimePoint& point) {
+        Append(point.timestamp, point.value);
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return size_;
+    }
+
+    // Объём сжатых данных без индекса блоков
+    [[nodiscard]] size_t ByteSize() const noexcept {
+        return bits_.Words().Size() * sizeof(uint64_t);
+    }
+
+    const Vector<Block>& Blocks() const noexcept {
+        return blocks_;
+    }
+
+    Cursor Begin() const noexcept {
+        return Cursor(this, 0);
+    }
+
+    // Курсор на первой точке с меткой не меньше timestamp: двоичный поиск
+    // по индексу блоков и декодирование внутри одного-двух блоков
+    Cursor Seek(int64_t timestamp) const noexcept {
+        auto it = std::lower_bound(blocks_.begin(), blocks_.end(), timestamp, [](const Block& block, int64_t value) {
+            return block.first_timestamp < value;
+        });
+        // Точки с искомой меткой могут заканчивать предыдущий блок
+        size_t block = it - blocks_.begin();
+        Cursor cursor(this, block == 0 ? 0 : block - 1);
+        while (cursor.Valid() && cursor.Point().timestamp < timestamp) {
+            cursor.Advance();
+        }
+        return cursor;
+    }
+
+    template <typename Func>
+    void ForEach(Func&& func) const {
+        for (Cursor cursor = Begin(); cursor.Valid(); cursor.Advance()) {
+            func(cursor.Point());
+        }
+    }
+
+private:
+    // Признак отсутствия окна значащих бит от предыдущего значения
+    static constexpr unsigned NO_WINDOW = 64;
+
+    // Корзины разности второго порядка после префикса '1': ширина знакового поля
+    // и префикс '10', '110', '1110'; значения вне корзин пишутся после '1111' целиком
+    struct DodBucket {
+        unsigned bits;
+        unsigned prefix;
+    };
+    static constexpr DodBucket DOD_BUCKETS[] = {{7, 0b10}, {9, 0b110}, {12, 0b1110}};
+
+    [[nodiscard]] size_t BlockOffset(size_t block) const noexcept {
+        return block < blocks_.Size() ? blocks_[block].bit_offset : bits_.BitSize();
+    }
+
+    void EncodeDelta(int64_t dod) {
+        if (dod == 0) {
+            bits_.Write(0, 1);
+            return;
+        }
+        unsigned prefix_bits = 2;
+        for (const auto& [bits, prefix] : DOD_BUCKETS) {
+            const int64_t limit = int64_t{1} << (bits - 1);
+            if (dod >= -limit && dod < limit) {
+                bits_.Write(prefix, prefix_bits);
+                bits_.Write(static_cast<uint64_t>(dod), bits);
+                return;
+            }
+            ++prefix_bits;
+        }
+        bits_.Write(0b1111, 4);
+        bits_.Write(static_cast<uint64_t>(dod), 64);
+    }
+
+    void EncodeXor(uint64_t xor_bits) {
+        if (xor_bits == 0) {
+            bits_.Write(0, 1);
+            return;
+        }
+        const unsigned leading = std::countl_zero(xor_bits);
+        const unsigned trailing = std::countr_zero(xor_bits);
+        if (leading_ != NO_WINDOW && leading >= leading_ && trailing >= trailing_) {
+            // Отличающиеся биты помещаются в окно предыдущего значения
+            bits_.Write(0b10, 2);
+            bits_.Write(xor_bits >> trailing_, 64 - leading_ - trailing_);
+        } else {
+            const unsigned length = 64 - leading - trailing;
+            bits_.Write(0b11, 2);
+            bits_.Write(leading, 6);
+            bits_.Write(length - 1, 6);
+            bits_.Write(xor_bits >> trailing, length);
+            leading_ = leading;
+            trailing_ = trailing;
+        }
+    }
+
+    size_t block_points_;
+    detail::BitWriter bits_;
+    Vector<Block> blocks_;
+    size_t size_ = 0;
+
+    // Состояние кодировщика: последняя точка и окно значащих бит
+    int64_t timestamp_ = 0;
+    int64_t delta_ = 0;
+    uint64_t value_bits_ = 0;
+    unsigned leading_ = NO_WINDOW;
+    unsigned trailing_ = 0;
+};
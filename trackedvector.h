@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+#include "vector.h"
+
+// Полуинтервал [begin, end) индексов изменённых элементов
+struct DirtyRange {
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+// Вектор, запоминающий изменённые блоки элементов. Все изменяющие операции
+// помечают затронутые блоки, CollectDirty возвращает их слитыми в диапазоны,
+// чтобы при репликации и сохранении на диск записывать только разницу.
+template <typename T, size_t BlockBytes = 4096>
+class TrackedVector {
+public:
+    using const_iterator = const T*;
+
+    // Количество элементов в одном отслеживаемом блоке
+    static constexpr size_t BLOCK_SIZE = BlockBytes / sizeof(T) > 0 ? BlockBytes / sizeof(T) : 1;
+
+    TrackedVector() = default;
+
+    explicit TrackedVector(size_t size)
+            : data_(size) {
+        MarkDirty(0, size);
+    }
+
+    // Изменяемые итераторы не предоставляются: запись в обход отслеживания
+    // привела бы к потере изменений
+    const_iterator begin() const noexcept {
+        return data_.begin();
+    }
+    const_iterator end() const noexcept {
+        return data_.end();
+    }
+
+    const_iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    const_iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    template <typename... Args>
+    const_iterator Emplace(const_iterator pos, Args&&... args) {
+        size_t offset = pos - begin();
+        data_.Emplace(pos, std::forward<Args>(args)...);
+        // Вставка сдвигает весь хвост
+        MarkDirty(offset, data_.Size());
+        return begin() + offset;
+    }
+
+    const_iterator Erase(const_iterator pos) {
+        size_t offset = pos - begin();
+        data_.Erase(pos);
+        MarkDirty(offset, data_.Size());
+        return begin() + offset;
+    }
+
+    void Reserve(size_t new_capacity) {
+        data_.Reserve(new_capacity);
+    }
+
+    void Resize(size_t new_size) {
+        size_t old_size = data_.Size();
+        data_.Resize(new_size);
+        MarkDirty(old_size, new_size);
+    }
+
+    template <typename Val>
+    void PushBack(Val&& value) {
+        EmplaceBack(std::forward<Val>(value));
+    }
+
+    void PopBack() noexcept {
+        data_.PopBack();
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        T& elem = data_.EmplaceBack(std::forward<Args>(args)...);
+        MarkDirty(data_.Size() - 1, data_.Size());
+        return elem;
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return data_.Size();
+    }
+
+    [[nodiscard]] size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return data_[index];
+    }
+
+    // Неконстантный доступ считается записью: блок элемента помечается изменённым
+    T& operator[](size_t index) noexcept {
+        MarkDirty(index, index + 1);
+        return data_[index];
+    }
+
+    const Vector<T>& Data() const noexcept {
+        return data_;
+    }
+
+    // Возвращает изменённые с прошлого вызова диапазоны (смежные блоки слиты,
+    // последний обрезан по размеру) и сбрасывает отметки
+    Vector<DirtyRange> CollectDirty() {
+        Vector<DirtyRange> ranges;
+        const size_t block_count = dirty_.Size() * WORD_BITS;
+
+        size_t block = FindBlock(0, true);
+        while (block < block_count) {
+            size_t block_end = FindBlock(block, false);
+            size_t first = block * BLOCK_SIZE;
+            size_t last = std::min(block_end * BLOCK_SIZE, data_.Size());
+            if (first < last) {
+                ranges.PushBack(DirtyRange{first, last});
+            }
+            block = FindBlock(block_end, true);
+        }
+
+        std::fill(dirty_.begin(), dirty_.end(), uint64_t{0});
+        return ranges;
+    }
+
+private:
+    static constexpr size_t WORD_BITS = 64;
+
+    Vector<T> data_;
+    // Битовая карта изменённых блоков
+    Vector<uint64_t> dirty_;
+
+    void MarkDirty(size_t first, size_t last) {
+        if (first >= last) {
+            return;
+        }
+
+        size_t block = first / BLOCK_SIZE;
+        const size_t last_block = (last - 1) / BLOCK_SIZE;
+        if (dirty_.Size() <= last_block / WORD_BITS) {
+            dirty_.Resize(last_block / WORD_BITS + 1);
+        }
+
+        while (block <= last_block) {
+            size_t bit = block % WORD_BITS;
+            size_t count = std::min(WORD_BITS - bit, last_block - block + 1);
+            uint64_t mask = count == WORD_BITS ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+            dirty_[block / WORD_BITS] |= mask << bit;
+            block += count;
+        }
+    }
+
+    // Находит первый блок, начиная с from, чей бит равен value
+    [[nodiscard]] size_t FindBlock(size_t from, bool value) const noexcept {
+        const size_t block_count = dirty_.Size() * WORD_BITS;
+        while (from < block_count) {
+            uint64_t word = value ? dirty_[from / WORD_BITS] : ~dirty_[from / WORD_BITS];
+            word >>= from % WORD_BITS;
+            if (word != 0) {
+                return from + std::countr_zero(word);
+            }
+            from += WORD_BITS - from % WORD_BITS;
+        }
+        return block_count;
+    }
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+namespace detail {
+
+template <typename T, typename... Ts>
+constexpr size_t IndexOfType() {
+    constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+    for (size_t i = 0; i < sizeof...(Ts); ++i) {
+        if (matches[i]) {
+            return i;
+        }
+    }
+    return sizeof...(Ts);
+}
+
+}  // namespace detail
+
+// Замена Vector<std::variant<Ts...>>: теги хранятся отдельным массивом байтов,
+// а значения — в плотных массивах своего типа, без выравнивания под самую
+// большую альтернативу. Visit обходит элементы в порядке добавления и выбирает
+// альтернативу один раз на серию одинаковых тегов
+template <typename... Ts>
+class VariantVector {
+    static_assert(sizeof...(Ts) > 0 && sizeof...(Ts) <= 256, "Tags are stored in one byte");
+
+public:
+    // Номер альтернативы T, хранящийся в теге
+    template <typename T>
+    static constexpr uint8_t TAG = static_cast<uint8_t>(detail::IndexOfType<T, Ts...>());
+
+    template <typename T, typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        static_assert(detail::IndexOfType<T, Ts...>() < sizeof...(Ts), "Type is not an alternative");
+        T& value = std::get<Vector<T>>(values_).EmplaceBack(std::forward<Args>(args)...);
+        try {
+            tags_.PushBack(TAG<T>);
+        } catch (...) {
+            std::get<Vector<T>>(values_).PopBack();
+            throw;
+        }
+        return value;
+    }
+
+    template <typename T>
+    void PushBack(T&& value) {
+        EmplaceBack<std::remove_cvref_t<T>>(std::forward<T>(value));
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return tags_.Size();
+    }
+
+    [[nodiscard]] uint8_t Tag(size_t index) const noexcept {
+        return tags_[index];
+    }
+
+    // Значения одной альтернативы в порядке добавления
+    template <typename T>
+    const Vector<T>& Values() const noexcept {
+        return std::get<Vector<T>>(values_);
+    }
+
+    template <typename T>
+    [[nodiscard]] size_t CountOf() const noexcept {
+        return Values<T>().Size();
+    }
+
+    void Clear() noexcept {
+        tags_.Clear();
+        std::apply([](auto&... values) {
+            (values.Clear(), ...);
+        }, values_);
+    }
+
+    // Вызывает func для каждого элемента с его конкретным типом в порядке добавления
+    template <typename Func>
+    void Visit(Func&& func) {
+        VisitImpl(*this, func, std::index_sequence_for<Ts...>{});
+    }
+
+    template <typename Func>
+    void Visit(Func&& func) const {
+        VisitImpl(*this, func, std::index_sequence_for<Ts...>{});
+    }
+
+private:
+    template <typename Self, typename Func, size_t... Is>
+    static void VisitImpl(Self& self, Func& func, std::index_sequence<Is...>) {
+        std::array<size_t, sizeof...(Ts)> cursors{};
+        const size_t size = self.tags_.Size();
+        size_t first = 0;
+        while (first < size) {
+            const uint8_t tag = self.tags_[first];
+            size_t last = first + 1;
+            while (last < size && self.tags_[last] == tag) {
+                ++last;
+            }
+            // Внутри серии цикл идёт по плотному массиву одного типа без ветвлений по тегу
+            ((tag == Is ? (VisitRun(std::get<Is>(self.values_), cursors[Is], last - first, func), true) : false)
+             || ...);
+            first = last;
+        }
+    }
+
+    template <typename Values, typename Func>
+    static void VisitRun(Values& values, size_t& cursor, size_t count, Func& func) {
+        for (size_t i = cursor; i < cursor + count; ++i) {
+            func(values[i]);
+        }
+        cursor += count;
+    }
+
+    Vector<uint8_t> tags_;
+    std::tuple<Vector<Ts>...> values_;
+};
@@ -6,6 +6,12 @@
 #include <utility>
 #include <memory>
 #include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <type_traits>
 
 #include "rawmemory.h"
 
@@ -171,6 +177,75 @@ public:
         size_ = new_size;
     }
 
+    void Resize(size_t new_size, const T& value) {
+        if (new_size > Capacity()) {
+            // value может ссылаться на элемент вектора, поэтому старый буфер
+            // освобождается только после заполнения нового
+            RawMemory<T> new_data(new_size);
+            UninitializedFillN(new_data.GetAddress() + size_, new_size - size_, value);
+
+            try {
+                ShiftDataToNewMemory(data_.GetAddress(), size_, new_data.GetAddress());
+            } catch (...) {
+                std::destroy_n(new_data.GetAddress() + size_, new_size - size_);
+                throw;
+            }
+
+            std::destroy_n(data_.GetAddress(), size_);
+            data_.Swap(new_data);
+        } else if (new_size > size_) {
+            UninitializedFillN(data_.GetAddress() + size_, new_size - size_, value);
+        } else {
+            std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+        }
+
+        size_ = new_size;
+    }
+
+    // Изменяет размер, не инициализируя новые элементы: вызывающий обязан
+    // перезаписать их до чтения
+    void ResizeForOverwrite(size_t new_size) {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "ResizeForOverwrite requires a trivial element type");
+        if (new_size > Capacity()) {
+            Reserve(new_size);
+        }
+        if (new_size > size_) {
+            std::uninitialized_default_construct_n(data_.GetAddress() + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    // Заменяет содержимое count копиями value, переиспользуя имеющуюся ёмкость:
+    // существующие элементы перезаписываются присваиванием
+    void Assign(size_t count, const T& value) {
+        if (count > Capacity()) {
+            RawMemory<T> new_data(count);
+            UninitializedFillN(new_data.GetAddress(), count, value);
+            std::destroy_n(data_.GetAddress(), size_);
+            data_.Swap(new_data);
+        } else {
+            FillN(data_.GetAddress(), std::min(size_, count), value);
+            if (count > size_) {
+                UninitializedFillN(data_.GetAddress() + size_, count - size_, value);
+            } else {
+                std::destroy_n(data_.GetAddress() + count, size_ - count);
+            }
+        }
+
+        size_ = count;
+    }
+
+    void Fill(const T& value) {
+        FillN(data_.GetAddress(), size_, value);
+    }
+
+    // Разрушает все элементы, сохраняя ёмкость
+    void Clear() noexcept {
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = 0;
+    }
+
     template <typename Val>
     void PushBack(Val&& value) {
         EmplaceBack(std::forward<Val>(value));
@@ -183,10 +258,28 @@ public:
         --size_;
     }
 
+    // Отдельно от Emplace: при добавлении в конец сдвигать нечего, и GCC не видит
+    // пустого переноса за конец новой памяти, о котором предупреждает -Warray-bounds
     template <typename... Args>
     T& EmplaceBack(Args&&... args) {
-        iterator it = Emplace(end(), std::forward<Args>(args)...);
-        return *it;
+        if (size_ == Capacity()) {
+            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
+            std::construct_at(new_data + size_, std::forward<Args>(args)...);
+
+            try {
+                ShiftDataToNewMemory(data_.GetAddress(), size_, new_data.GetAddress());
+            } catch (...) {
+                std::destroy_at(new_data + size_);
+                throw;
+            }
+
+            std::destroy_n(data_.GetAddress(), size_);
+            data_.Swap(new_data);
+        } else {
+            std::construct_at(end(), std::forward<Args>(args)...);
+        }
+
+        return data_[size_++];
     }
 
     void Swap(Vector& other) noexcept {
@@ -216,6 +309,40 @@ private:
     size_t size_ = 0;
 
 
+    // Возвращает true, если все байты представления value одинаковы и заполнение
+    // можно выполнить через memset
+    static bool IsByteSplat(const T& value, unsigned char& byte) noexcept {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, std::addressof(value), sizeof(T));
+            byte = bytes[0];
+            return std::all_of(bytes + 1, bytes + sizeof(T), [b = bytes[0]](unsigned char c) {
+                return c == b;
+            });
+        } else {
+            return false;
+        }
+    }
+
+    static void FillN(T* buf, size_t count, const T& value) {
+        unsigned char byte;
+        if (count != 0 && IsByteSplat(value, byte)) {
+            std::memset(static_cast<void*>(buf), byte, count * sizeof(T));
+        } else {
+            // Для тривиально копируемых типов компилятор разворачивает цикл в векторные записи
+            std::fill_n(buf, count, value);
+        }
+    }
+
+    static void UninitializedFillN(T* buf, size_t count, const T& value) {
+        unsigned char byte;
+        if (count != 0 && IsByteSplat(value, byte)) {
+            std::memset(static_cast<void*>(buf), byte, count * sizeof(T));
+        } else {
+            std::uninitialized_fill_n(buf, count, value);
+        }
+    }
+
     void ShiftDataToNewMemory(T* old_buf, size_t count, T* new_buf) {
         if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
             std::uninitialized_move_n(old_buf, count, new_buf);
@@ -223,4 +350,63 @@ private:
             std::uninitialized_copy_n(old_buf, count, new_buf);
         }
     }
+};
+
+namespace detail {
+
+// Типы, для которых лексикографический порядок байтов совпадает с порядком элементов
+template <typename T>
+inline constexpr bool IS_BYTE_LIKE_V = std::is_same_v<T, unsigned char> || std::is_same_v<T, std::byte>
+                                       || std::is_same_v<T, char8_t>
+                                       || (std::is_same_v<T, char> && std::is_unsigned_v<char>);
+
+// Типы, равенство которых совпадает с побайтовым. Для классов это не так даже
+// без паддинга: пользовательский operator== может сравнивать иначе
+template <typename T>
+inline constexpr bool IS_BITWISE_EQUAL_V = std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>;
+
+}  // namespace detail
+
+// Для целых, перечислений и указателей сравнение сводится к memcmp
+template <typename T>
+bool operator==(const Vector<T>& lhs, const Vector<T>& rhs) {
+    if (lhs.Size() != rhs.Size()) {
+        return false;
+    }
+    if constexpr (detail::IS_BITWISE_EQUAL_V<T>) {
+        return lhs.Size() == 0 || std::memcmp(lhs.begin(), rhs.begin(), lhs.Size() * sizeof(T)) == 0;
+    } else {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+}
+
+template <std::three_way_comparable T>
+std::compare_three_way_result_t<T> operator<=>(const Vector<T>& lhs, const Vector<T>& rhs) {
+    if constexpr (detail::IS_BYTE_LIKE_V<T>) {
+        size_t common = std::min(lhs.Size(), rhs.Size());
+        int cmp = common == 0 ? 0 : std::memcmp(lhs.begin(), rhs.begin(), common);
+        if (cmp != 0) {
+            return cmp < 0 ? std::strong_ordering::less : std::strong_ordering::greater;
+        }
+        return lhs.Size() <=> rhs.Size();
+    } else {
+        return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+}
+
+template <typename T>
+struct std::hash<Vector<T>> {
+    size_t operator()(const Vector<T>& vec) const noexcept {
+        if constexpr (detail::IS_BITWISE_EQUAL_V<T>) {
+            // Равные векторы таких типов совпадают побайтно
+            std::string_view bytes(reinterpret_cast<const char*>(vec.begin()), vec.Size() * sizeof(T));
+            return std::hash<std::string_view>{}(bytes);
+        } else {
+            size_t seed = vec.Size();
+            for (const T& value : vec) {
+                seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+            }
+            return seed;
+        }
+    }
 };
\ No newline at end of file
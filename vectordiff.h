@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "vector.h"
+
+// Участок патча: length байт, которые нужно записать по смещению offset
+struct PatchRun {
+    size_t offset = 0;
+    size_t length = 0;
+};
+
+// Разница между двумя снимками вектора. Данные всех участков хранятся подряд в bytes
+struct Patch {
+    // Количество элементов в целевом векторе
+    size_t size = 0;
+    Vector<PatchRun> runs;
+    Vector<std::byte> bytes;
+};
+
+namespace detail {
+
+// Гранулярность сравнения: изменённые блоки попадают в патч целиком
+inline constexpr size_t DIFF_BLOCK = 32;
+// Размер окна, равенство которого проверяется одним memcmp до поблочного сравнения
+inline constexpr size_t DIFF_WINDOW = 4096;
+
+inline void AppendRun(Patch& patch, size_t offset, const std::byte* data, size_t length) {
+    if (patch.runs.Size() > 0) {
+        PatchRun& last = patch.runs[patch.runs.Size() - 1];
+        if (last.offset + last.length == offset) {
+            last.length += length;
+        } else {
+            patch.runs.PushBack(PatchRun{offset, length});
+        }
+    } else {
+        patch.runs.PushBack(PatchRun{offset, length});
+    }
+
+    size_t old_size = patch.bytes.Size();
+    if (old_size + length > patch.bytes.Capacity()) {
+        patch.bytes.Reserve(std::max(old_size + length, patch.bytes.Capacity() * 2));
+    }
+    patch.bytes.Resize(old_size + length);
+    std::memcpy(patch.bytes.begin() + old_size, data, length);
+}
+
+}  // namespace detail
+
+// Строит патч, превращающий a в b. Сначала сравниваются крупные окна, и только
+// в отличающихся окнах ищутся изменённые 32-байтовые блоки
+template <typename T>
+Patch Diff(const Vector<T>& a, const Vector<T>& b) {
+    static_assert(std::is_trivially_copyable_v<T>, "Diff requires trivially copyable elements");
+
+    Patch patch;
+    patch.size = b.Size();
+
+    const auto* pa = reinterpret_cast<const std::byte*>(a.begin());
+    const auto* pb = reinterpret_cast<const std::byte*>(b.begin());
+    const size_t common = std::min(a.Size(), b.Size()) * sizeof(T);
+
+    for (size_t window = 0; window < common; window += detail::DIFF_WINDOW) {
+        size_t window_end = std::min(window + detail::DIFF_WINDOW, common);
+        if (std::memcmp(pa + window, pb + window, window_end - window) == 0) {
+            continue;
+        }
+        for (size_t block = window; block < window_end; block += detail::DIFF_BLOCK) {
+            size_t length = std::min(detail::DIFF_BLOCK, window_end - block);
+            if (std::memcmp(pa + block, pb + block, length) != 0) {
+                detail::AppendRun(patch, block, pb + block, length);
+            }
+        }
+    }
+
+    const size_t total = b.Size() * sizeof(T);
+    if (total > common) {
+        detail::AppendRun(patch, common, pb + common, total - common);
+    }
+
+    return patch;
+}
+
+// Применяет патч, построенный Diff, к вектору-источнику. Патч проверяется
+// целиком до изменения dst: некорректный патч не оставляет вектор наполовину изменённым
+template <typename T>
+void Apply(const Patch& patch, Vector<T>& dst) {
+    static_assert(std::is_trivially_copyable_v<T>, "Apply requires trivially copyable elements");
+
+    if (patch.size > std::numeric_limits<size_t>::max() / sizeof(T)) {
+        throw std::length_error("Patch size is too large");
+    }
+    const size_t total = patch.size * sizeof(T);
+    size_t consumed = 0;
+    for (const PatchRun& run : patch.runs) {
+        if (run.offset > total || run.length > total - run.offset) {
+            throw std::out_of_range("Patch run exceeds vector size");
+        }
+        if (run.length > patch.bytes.Size() - consumed) {
+            throw std::out_of_range("Patch runs exceed patch data");
+        }
+        consumed += run.length;
+    }
+    if (consumed != patch.bytes.Size()) {
+        throw std::invalid_argument("Patch data does not match its runs");
+    }
+
+    dst.Resize(patch.size);
+
+    auto* out = reinterpret_cast<std::byte*>(dst.begin());
+    const std::byte* in = patch.bytes.begin();
+    for (const PatchRun& run : patch.runs) {
+        std::memcpy(out + run.offset, in, run.length);
+        in += run.length;
+    }
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "rawmemory.h"
+
+// Способ свёртки factor соседних отсчётов в один отсчёт более грубого уровня
+enum class Downsample {
+    SUM,
+    MEAN,
+    MIN,
+    MAX,
+    LAST,
+};
+
+// Окно последних Capacity() отсчётов в кольцевом буфере: новый отсчёт
+// вытесняет самый старый. Сумма, минимум и максимум окна поддерживаются
+// за амортизированное O(1) на добавление: минимум и максимум — монотонными
+// очередями номеров отсчётов.
+//
+// К окну можно подключить более грубый уровень (Cascade): каждые factor
+// отсчётов в него добавляется их свёртка, так что цепочка уровней хранит
+// одну и ту же метрику с разным разрешением и глубиной
+template <typename T>
+class WindowRing {
+    static_assert(std::is_arithmetic_v<T>, "WindowRing requires arithmetic samples");
+
+public:
+    using SumType = std::conditional_t<std::is_floating_point_v<T>, double,
+                                       std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+    explicit WindowRing(size_t capacity)
+            : samples_(capacity)
+            , min_(capacity)
+            , max_(capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("WindowRing capacity must be positive");
+        }
+    }
+
+    void Push(T value) {
+        const size_t capacity = Capacity();
+        if (pushed_ >= capacity) {
+            const uint64_t expired = pushed_ - capacity;
+            sum_ -= samples_[expired % capacity];
+            min_.PopFrontIf(expired);
+            max_.PopFrontIf(expired);
+        }
+        while (!min_.Empty() && !(At(min_.Back()) < value)) {
+            min_.PopBack();
+        }
+        while (!max_.Empty() && !(value < At(max_.Back()))) {
+            max_.PopBack();
+        }
+        samples_[pushed_ % capacity] = value;
+        min_.PushBack(pushed_);
+        max_.PushBack(pushed_);
+        sum_ += value;
+        ++pushed_;
+
+        if (coarser_) {
+            Accumulate(value);
+        }
+    }
+
+    [[nodiscard]] size_t Size() const noexcept {
+        return pushed_ < Capacity() ? static_cast<size_t>(pushed_) : Capacity();
+    }
+
+    [[nodiscard]] size_t Capacity() const noexcept {
+        return samples_.Capacity();
+    }
+
+    [[nodiscard]] bool Full() const noexcept {
+        return pushed_ >= Capacity();
+    }
+
+    // Количество отсчётов, добавленных за всё время
+    [[nodiscard]] uint64_t PushCount() const noexcept {
+        return pushed_;
+    }
+
+    // Отсчёт index, считая от самого старого в окне
+    T operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return At(pushed_ - Size() + index);
+    }
+
+    T Back() const noexcept {
+        assert(Size() > 0);
+        return At(pushed_ - 1);
+    }
+
+    // Для дробных T сумма поддерживается вычитанием вытесненных отсчётов
+    // и может накапливать ошибку округления
+    [[nodiscard]] SumType Sum() const noexcept {
+        return sum_;
+    }
+
+    [[nodiscard]] double Mean() const noexcept {
+        assert(Size() > 0);
+        return static_cast<double>(sum_) / static_cast<double>(Size());
+    }
+
+    T Min() const noexcept {
+        assert(Size() > 0);
+        return At(min_.Front());
+    }
+
+    T Max() const noexcept {
+        assert(Size() > 0);
+        return At(max_.Front());
+    }
+
+    // Подключает более грубый уровень и возвращает его. Отсчёт уровня — свёртка
+    // mode очередных factor отсчётов этого окна; прежний уровень заменяется
+    WindowRing& Cascade(size_t factor, size_t capacity, Downsample mode = Downsample::MEAN) {
+        if (factor == 0) {
+            throw std::invalid_argument("Downsampling factor must be positive");
+        }
+        coarser_ = std::make_unique<WindowRing>(capacity);
+        factor_ = factor;
+        mode_ = mode;
+        bucket_count_ = 0;
+        return *coarser_;
+    }
+
+    // Уровень level цепочки: 0 — само окно
+    const WindowRing& Level(size_t level) const {
+        const WindowRing* ring = this;
+        for (; level > 0; --level) {
+            if (!ring->coarser_) {
+                throw std::out_of_range("No such downsampling level");
+            }
+            ring = ring->coarser_.get();
+        }
+        return *ring;
+    }
+
+private:
+    // Кольцевая очередь номеров отсчётов; в монотонной очереди их не больше
+    // ёмкости окна, поэтому переполнение невозможно
+    class IndexQueue {
+    public:
+        explicit IndexQueue(size_t capacity)
+                : data_(capacity) {
+        }
+
+        [[nodiscard]] bool Empty() const noexcept {
+            return size_ == 0;
+        }
+
+        uint64_t Front() const noexcept {
+            assert(size_ > 0);
+            return data_[head_];
+        }
+
+        uint64_t Back() const noexcept {
+            assert(size_ > 0);
+            return data_[(head_ + size_ - 1) % data_.Capacity()];
+        }
+
+        void PushBack(uint64_t index) noexcept {
+            assert(size_ < data_.Capacity());
+            data_[(head_ + size_) % data_.Capacity()] = index;
+            ++size_;
+        }
+
+        void PopBack() noexcept {
+            assert(size_ > 0);
+            --size_;
+        }
+
+        void PopFrontIf(uint64_t index) noexcept {
+            if (size_ > 0 && data_[head_] == index) {
+                head_ = (head_ + 1) % data_.Capacity();
+                --size_;
+            }
+        }
+
+    private:
+        RawMemory<uint64_t> data_;
+        size_t head_ = 0;
+        size_t size_ = 0;
+    };
+
+    T At(uint64_t index) const noexcept {
+        return samples_[index % Capacity()];
+    }
+
+    // Свёртка текущей группы для грубого уровня считается по мере поступления
+    void Accumulate(T value) {
+        if (bucket_count_ == 0) {
+            bucket_sum_ = value;
+            bucket_value_ = value;
+        } else {
+            bucket_sum_ += value;
+            switch (mode_) {
+                case Downsample::MIN:
+                    bucket_value_ = value < bucket_value_ ? value : bucket_value_;
+                    break;
+                case Downsample::MAX:
+                    bucket_value_ = bucket_value_ < value ? value : bucket_value_;
+                    break;
+                default:
+                    bucket_value_ = value;
+                    break;
+            }
+        }
+        if (++bucket_count_ < factor_) {
+            return;
+        }
+
+        bucket_count_ = 0;
+        switch (mode_) {
+            case Downsample::SUM:
+                coarser_->Push(static_cast<T>(bucket_sum_));
+                break;
+            case Downsample::MEAN:
+                coarser_->Push(static_cast<T>(bucket_sum_ / static_cast<SumType>(factor_)));
+                break;
+            default:
+                coarser_->Push(bucket_value_);
+                break;
+        }
+    }
+
+    RawMemory<T> samples_;
+    IndexQueue min_;
+    IndexQueue max_;
+    uint64_t pushed_ = 0;
+    SumType sum_{};
+
+    std::unique_ptr<WindowRing> coarser_;
+    size_t factor_ = 0;
+    Downsample mode_ = Downsample::MEAN;
+    size_t bucket_count_ = 0;
+    SumType bucket_sum_{};
+    T bucket_value_{};
+};
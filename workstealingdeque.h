@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+#include "rawmemory.h"
+#include "vector.h"
+
+// Дек Чейза-Лева для планировщика задач. Владелец кладёт и забирает элементы
+// с нижнего конца без блокировок, другие потоки крадут с верхнего.
+// Порядки памяти соответствуют работе Lê et al., «Correct and Efficient
+// Work-Stealing for Weak Memory Models» (PPoPP 2013)
+template <typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "Elements are read racily and must be trivially copyable");
+
+public:
+    explicit WorkStealingDeque(size_t capacity = 64)
+            : array_(new Array(std::bit_ceil(capacity < 2 ? size_t{2} : capacity))) {
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    ~WorkStealingDeque() {
+        delete array_.load(std::memory_order_relaxed);
+    }
+
+    // Вызывается только владельцем
+    void Push(T value) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        Array* array = array_.load(std::memory_order_relaxed);
+
+        if (bottom - top > static_cast<int64_t>(array->Capacity()) - 1) {
+            array = Grow(array, top, bottom);
+        }
+
+        array->Store(bottom, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // Вызывается только владельцем, забирает последний добавленный элемент
+    std::optional<T> Pop() {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* array = array_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        std::optional<T> value = array->Load(bottom);
+        if (top == bottom) {
+            // Последний элемент: состязаемся с ворами
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                value.reset();
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    // Может вызываться из любого потока. Пустой результат означает, что дек пуст
+    // либо элемент забрал другой поток
+    std::optional<T> Steal() {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return std::nullopt;
+        }
+
+        Array* array = array_.load(std::memory_order_acquire);
+        T value = array->Load(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    // Приблизительный размер: при одновременной работе других потоков может устареть
+    [[nodiscard]] size_t Size() const noexcept {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    [[nodiscard]] bool Empty() const noexcept {
+        return Size() == 0;
+    }
+
+private:
+    // Кольцевой буфер на сырой памяти; индексы берутся по модулю ёмкости
+    class Array {
+    public:
+        explicit Array(size_t capacity)
+                : slots_(capacity) {
+            std::uninitialized_default_construct_n(slots_.GetAddress(), capacity);
+        }
+
+        ~Array() {
+            std::destroy_n(slots_.GetAddress(), slots_.Capacity());
+        }
+
+        [[nodiscard]] size_t Capacity() const noexcept {
+            return slots_.Capacity();
+        }
+
+        T Load(int64_t index) const noexcept {
+            return slots_[static_cast<size_t>(index) & (Capacity() - 1)].load(std::memory_order_relaxed);
+        }
+
+        void Store(int64_t index, T value) noexcept {
+            slots_[static_cast<size_t>(index) & (Capacity() - 1)].store(value, std::memory_order_relaxed);
+        }
+
+    private:
+        RawMemory<std::atomic<T>> slots_;
+    };
+
+    Array* Grow(Array* old_array, int64_t top, int64_t bottom) {
+        auto new_array = std::make_unique<Array>(old_array->Capacity() * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            new_array->Store(i, old_array->Load(i));
+        }
+
+        // Воры могут всё ещё читать старый буфер, поэтому он освобождается
+        // только вместе с деком
+        retired_.EmplaceBack(old_array);
+        Array* result = new_array.release();
+        array_.store(result, std::memory_order_release);
+        return result;
+    }
+
+    alignas(64) std::atomic<int64_t> top_ = 0;
+    alignas(64) std::atomic<int64_t> bottom_ = 0;
+    std::atomic<Array*> array_;
+    // Доступен только владельцу
+    Vector<std::unique_ptr<Array>> retired_;
+};